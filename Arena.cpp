@@ -0,0 +1,80 @@
+#include "Arena.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+Arena::Arena(size_t first_block_size)
+    : cursor_(nullptr),
+    end_(nullptr),
+    first_block_size_(std::max<size_t>(first_block_size, 1)),
+    block_size_(first_block_size_),
+    bytes_allocated_(0) {
+}
+
+Arena::Arena(Arena&& other) noexcept
+    : blocks_(std::move(other.blocks_)),
+    cursor_(other.cursor_),
+    end_(other.end_),
+    first_block_size_(other.first_block_size_),
+    block_size_(other.block_size_),
+    bytes_allocated_(other.bytes_allocated_) {
+    other.reset();
+}
+
+Arena& Arena::operator=(Arena&& other) noexcept {
+    if (this != &other) {
+        blocks_ = std::move(other.blocks_);
+        cursor_ = other.cursor_;
+        end_ = other.end_;
+        first_block_size_ = other.first_block_size_;
+        block_size_ = other.block_size_;
+        bytes_allocated_ = other.bytes_allocated_;
+        other.reset();
+    }
+    return *this;
+}
+
+void* Arena::allocate(size_t size, size_t alignment) {
+    uintptr_t address = reinterpret_cast<uintptr_t>(cursor_);
+    size_t padding = (alignment - address % alignment) % alignment;
+    if (cursor_ == nullptr || static_cast<size_t>(end_ - cursor_) < padding + size) {
+        size_t needed = size + alignment - 1;
+        size_t block_size = block_size_;
+        if (needed > block_size) block_size = needed;
+        else block_size_ = std::min(block_size_ * 2, MAX_BLOCK_SIZE);
+        // Left uninitialized: callers write everything they allocate.
+        blocks_.emplace_back(new unsigned char[block_size]);
+        cursor_ = blocks_.back().get();
+        end_ = cursor_ + block_size;
+        bytes_allocated_ += block_size;
+        address = reinterpret_cast<uintptr_t>(cursor_);
+        padding = (alignment - address % alignment) % alignment;
+    }
+    void* result = cursor_ + padding;
+    cursor_ += padding + size;
+    return result;
+}
+
+std::string_view Arena::store(std::string_view text) {
+    if (text.empty()) return std::string_view();
+    char* copy = static_cast<char*>(allocate(text.size(), 1));
+    std::memcpy(copy, text.data(), text.size());
+    return std::string_view(copy, text.size());
+}
+
+void Arena::reset() {
+    blocks_.clear();
+    cursor_ = nullptr;
+    end_ = nullptr;
+    block_size_ = first_block_size_;
+    bytes_allocated_ = 0;
+}
+
+size_t Arena::getBlockCount() const {
+    return blocks_.size();
+}
+
+size_t Arena::getBytesAllocated() const {
+    return bytes_allocated_;
+}
\ No newline at end of file
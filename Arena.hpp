@@ -0,0 +1,51 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Monotonic allocator: hands out memory from a few large blocks and frees it all at once when the
+// arena is destroyed or reset. Blocks double in size up to MAX_BLOCK_SIZE, so the block count grows
+// only logarithmically with the total. Nothing allocated from it is ever destroyed individually,
+// so only trivially destructible objects may live in it. Not thread-safe.
+class Arena {
+public:
+    static constexpr size_t MAX_BLOCK_SIZE = size_t(64) << 20;
+
+    explicit Arena(size_t first_block_size = size_t(64) << 10);
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena(Arena&& other) noexcept;
+    Arena& operator=(Arena&& other) noexcept;
+
+    // Requests larger than the block size get a block of their own.
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template <typename T>
+    T* allocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena objects are never destroyed");
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // Copies text into the arena; the view stays valid as long as the arena does.
+    std::string_view store(std::string_view text);
+
+    // Frees every block. Everything handed out before becomes invalid.
+    void reset();
+
+    size_t getBlockCount() const;
+    size_t getBytesAllocated() const;
+
+private:
+    std::vector<std::unique_ptr<unsigned char[]>> blocks_;
+    unsigned char* cursor_;
+    unsigned char* end_;
+    size_t first_block_size_;
+    size_t block_size_;
+    size_t bytes_allocated_;
+};
+
+#endif
\ No newline at end of file
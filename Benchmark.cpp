@@ -0,0 +1,518 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "CharClass.hpp"
+#include "ConfigManager.hpp"
+#include "CorpusGenerator.hpp"
+#include "GuessEstimator.hpp"
+#include "Logger.hpp"
+#include "MarkovModel.hpp"
+#include "PasswordAnalyzer.hpp"
+#include "PasswordChecker.hpp"
+#include "PasswordGenerator.hpp"
+#include "ThreadPool.hpp"
+#include "Utils.hpp"
+#include "WordList.hpp"
+#include "WordMatcher.hpp"
+
+namespace {
+    constexpr size_t CORPUS_SIZE = 4096;
+
+    enum class OutputFormat {
+        TEXT,
+        CSV
+    };
+
+    struct BenchmarkOptions {
+        std::string filter;
+        double min_time = 0.2;
+        int repetitions = 5;
+        uint64_t seed = 1;
+        OutputFormat format = OutputFormat::TEXT;
+        bool list_only = false;
+        size_t generate_count = 0;
+        std::string generate_path;
+    };
+
+    // A body runs the measured operation `iterations` times and returns a value derived from the
+    // results, so the optimizer cannot drop the work. Setup builds the body and its inputs, and only
+    // runs for benchmarks that pass the filter.
+    using BenchmarkBody = std::function<uint64_t(uint64_t iterations)>;
+
+    struct Benchmark {
+        std::string name;
+        std::function<BenchmarkBody()> setup;
+    };
+
+    struct BenchmarkResult {
+        uint64_t iterations;
+        double median_ns;
+        double min_ns;
+    };
+
+    volatile uint64_t benchmark_sink = 0;
+
+    double runOnce(const BenchmarkBody& body, uint64_t iterations) {
+        auto start = std::chrono::steady_clock::now();
+        benchmark_sink = benchmark_sink + body(iterations);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    BenchmarkResult measure(const BenchmarkBody& body, const BenchmarkOptions& options) {
+        // Grow the iteration count until one run takes about min_time, then time the repetitions.
+        uint64_t iterations = 1;
+        double elapsed = runOnce(body, iterations);
+        while (elapsed < options.min_time && iterations < (uint64_t(1) << 40)) {
+            double scale = elapsed > 0 ? options.min_time / elapsed * 1.2 : 100.0;
+            iterations = std::max(iterations + 1, static_cast<uint64_t>(iterations * std::min(scale, 100.0)));
+            elapsed = runOnce(body, iterations);
+        }
+
+        std::vector<double> samples;
+        samples.push_back(elapsed);
+        for (int i = 1; i < options.repetitions; ++i) samples.push_back(runOnce(body, iterations));
+        std::sort(samples.begin(), samples.end());
+
+        BenchmarkResult result;
+        result.iterations = iterations;
+        result.median_ns = samples[samples.size() / 2] * 1e9 / iterations;
+        result.min_ns = samples.front() * 1e9 / iterations;
+        return result;
+    }
+
+    class TempFile {
+    public:
+        explicit TempFile(const std::string& name)
+            : path_((std::filesystem::temp_directory_path() / ("password_checker_bench_" + name)).string()) {
+        }
+
+        ~TempFile() {
+            std::error_code ignored;
+            std::filesystem::remove(path_, ignored);
+        }
+
+        const std::string& path() const {
+            return path_;
+        }
+
+    private:
+        std::string path_;
+    };
+
+    // Members are destroyed in reverse order, so the log is closed before its file is removed.
+    struct LoggerFixture {
+        TempFile file;
+        Logger logger;
+
+        explicit LoggerFixture(const std::string& name) : file(name), logger(file.path()) {
+        }
+
+        LoggerFixture(const std::string& name, const AsyncLogOptions& async) : file(name), logger(file.path(), async) {
+        }
+    };
+
+    std::string lengthLabel(size_t min_length, size_t max_length) {
+        return std::to_string(min_length) + "_" + std::to_string(max_length);
+    }
+
+    // A fixed policy without the dictionary and breach lookups, as an embedded validator would use.
+    struct CharacterOnlyRules : DefaultPolicyRules {
+        static constexpr unsigned CHECKS = PolicyCheck::ALL & ~(PolicyCheck::NO_COMMON_WORD | PolicyCheck::NOT_BREACHED);
+    };
+
+    // Maps ASCII letters onto the first 26 Cyrillic letters of the same case, keeping the rest.
+    std::string toCyrillic(const std::string& password) {
+        std::string converted;
+        for (char c : password) {
+            unsigned code_point;
+            if (c >= 'a' && c <= 'z') code_point = 0x0430 + (c - 'a');
+            else if (c >= 'A' && c <= 'Z') code_point = 0x0410 + (c - 'A');
+            else {
+                converted += c;
+                continue;
+            }
+            converted += static_cast<char>(0xC0 | (code_point >> 6));
+            converted += static_cast<char>(0x80 | (code_point & 0x3F));
+        }
+        return converted;
+    }
+
+    Benchmark charactersBenchmark(const std::string& name, TextEncoding encoding, bool cyrillic, uint64_t seed) {
+        return { name, [encoding, cyrillic, seed] {
+            auto corpus = std::make_shared<std::vector<std::string>>(CorpusGenerator(seed).generate(CORPUS_SIZE));
+            if (cyrillic) {
+                for (auto& password : *corpus) password = toCyrillic(password);
+            }
+            return BenchmarkBody([encoding, corpus](uint64_t n) {
+                uint64_t sum = 0;
+                for (uint64_t i = 0; i < n; ++i) {
+                    sum += PasswordAnalyzer::analyzeCharacters((*corpus)[i % CORPUS_SIZE], encoding).unique_chars;
+                }
+                return sum;
+            });
+        } };
+    }
+
+    template <typename Policy>
+    Benchmark analyzeBenchmark(const std::string& name, const ConfigManager& config, uint64_t seed) {
+        return { name, [&config, seed] {
+            auto checker = std::make_shared<BasicPasswordChecker<Policy>>(config);
+            auto corpus = std::make_shared<std::vector<std::string>>(CorpusGenerator(seed).generate(CORPUS_SIZE));
+            return BenchmarkBody([checker, corpus](uint64_t n) {
+                uint64_t sum = 0;
+                for (uint64_t i = 0; i < n; ++i) {
+                    sum += static_cast<uint64_t>(checker->evaluateStrength(checker->analyze((*corpus)[i % CORPUS_SIZE])));
+                }
+                return sum;
+            });
+        } };
+    }
+
+    void addCheckBenchmarks(std::vector<Benchmark>& benchmarks, const ConfigManager& config, uint64_t seed) {
+        static const size_t BUCKETS[][2] = { { 1, 7 }, { 8, 11 }, { 12, 15 }, { 16, 31 }, { 32, 64 } };
+
+        for (const auto& bucket : BUCKETS) {
+            size_t min_length = bucket[0], max_length = bucket[1];
+            benchmarks.push_back({ "check/length_" + lengthLabel(min_length, max_length), [&config, seed, min_length, max_length] {
+                auto checker = std::make_shared<PasswordChecker>(config);
+                auto corpus = std::make_shared<std::vector<std::string>>(
+                    CorpusGenerator(seed).generate(CORPUS_SIZE, min_length, max_length));
+                return BenchmarkBody([checker, corpus](uint64_t n) {
+                    uint64_t sum = 0;
+                    for (uint64_t i = 0; i < n; ++i) {
+                        sum += static_cast<uint64_t>(checker->check((*corpus)[i % CORPUS_SIZE]).getStrength());
+                    }
+                    return sum;
+                });
+            } });
+        }
+
+        benchmarks.push_back({ "check/mixed", [&config, seed] {
+            auto checker = std::make_shared<PasswordChecker>(config);
+            auto corpus = std::make_shared<std::vector<std::string>>(CorpusGenerator(seed).generate(CORPUS_SIZE));
+            return BenchmarkBody([checker, corpus](uint64_t n) {
+                uint64_t sum = 0;
+                for (uint64_t i = 0; i < n; ++i) {
+                    sum += static_cast<uint64_t>(checker->check((*corpus)[i % CORPUS_SIZE]).getStrength());
+                }
+                return sum;
+            });
+        } });
+
+        // One iteration checks the whole corpus and renders every report.
+        benchmarks.push_back({ "check/batch_4096_details", [&config, seed] {
+            auto checker = std::make_shared<PasswordChecker>(config);
+            auto corpus = std::make_shared<std::vector<std::string>>(CorpusGenerator(seed).generate(CORPUS_SIZE));
+            return BenchmarkBody([checker, corpus](uint64_t n) {
+                uint64_t sum = 0;
+                for (uint64_t i = 0; i < n; ++i) {
+                    CheckBatch batch = checker->checkBatch(*corpus);
+                    for (size_t j = 0; j < batch.size(); ++j) sum += batch.getDetails(j).size();
+                }
+                return sum;
+            });
+        } });
+
+        benchmarks.push_back(analyzeBenchmark<ConfigPolicy>("analyze/mixed", config, seed));
+        benchmarks.push_back(analyzeBenchmark<StaticPolicy<DefaultPolicyRules>>("analyze/static_default", config, seed));
+        benchmarks.push_back(analyzeBenchmark<StaticPolicy<CharacterOnlyRules>>("analyze/static_characters_only", config, seed));
+
+        benchmarks.push_back({ "analyze/guesses", [&config, seed] {
+            auto corpus = std::make_shared<std::vector<std::string>>(CorpusGenerator(seed).generate(CORPUS_SIZE));
+            return BenchmarkBody([&config, corpus](uint64_t n) {
+                double sum = 0.0;
+                for (uint64_t i = 0; i < n; ++i) {
+                    sum += GuessEstimator::log10Guesses((*corpus)[i % CORPUS_SIZE], config.getWordMatcher());
+                }
+                return static_cast<uint64_t>(sum);
+            });
+        } });
+
+        benchmarks.push_back(charactersBenchmark("characters/bytes", TextEncoding::BYTES, false, seed));
+        benchmarks.push_back(charactersBenchmark("characters/utf8_ascii", TextEncoding::UTF8, false, seed));
+        benchmarks.push_back(charactersBenchmark("characters/utf8_cyrillic", TextEncoding::UTF8, true, seed));
+
+        benchmarks.push_back({ "markov/cost", [seed] {
+            std::stringstream training;
+            for (const auto& password : CorpusGenerator(seed + 3).generate(100000)) training << password << "\n";
+            auto file = std::make_shared<TempFile>("markov.bin");
+            MarkovModel::train(training, file->path(), false);
+            auto model = std::make_shared<MarkovModel>(file->path());
+            auto corpus = std::make_shared<std::vector<std::string>>(CorpusGenerator(seed).generate(CORPUS_SIZE));
+            return BenchmarkBody([file, model, corpus](uint64_t n) {
+                uint64_t sum = 0;
+                for (uint64_t i = 0; i < n; ++i) sum += model->quantizedCost((*corpus)[i % CORPUS_SIZE]);
+                return sum;
+            });
+        } });
+
+        // Every lookup hits: the corpus fits in the cache and is warmed up during setup.
+        benchmarks.push_back({ "analyze/cached_hit", [&config, seed] {
+            auto checker = std::make_shared<PasswordChecker>(config);
+            auto corpus = std::make_shared<std::vector<std::string>>(CorpusGenerator(seed).generate(CORPUS_SIZE));
+            checker->setCacheCapacity(CORPUS_SIZE * 2);
+            for (const auto& password : *corpus) checker->analyze(password);
+            return BenchmarkBody([checker, corpus](uint64_t n) {
+                uint64_t sum = 0;
+                for (uint64_t i = 0; i < n; ++i) sum += checker->analyze((*corpus)[i % CORPUS_SIZE]).length;
+                return sum;
+            });
+        } });
+    }
+
+    void addWordBenchmarks(std::vector<Benchmark>& benchmarks, uint64_t seed) {
+        static const size_t DICTIONARY_SIZES[] = { 16, 1000, 100000 };
+
+        for (size_t size : DICTIONARY_SIZES) {
+            std::string label = std::to_string(size);
+            benchmarks.push_back({ "words/contains_any_" + label, [seed, size] {
+                auto matcher = std::make_shared<WordMatcher>(CorpusGenerator(seed + 1).dictionary(size));
+                auto corpus = std::make_shared<std::vector<std::string>>(CorpusGenerator(seed).generate(CORPUS_SIZE));
+                return BenchmarkBody([matcher, corpus](uint64_t n) {
+                    uint64_t sum = 0;
+                    for (uint64_t i = 0; i < n; ++i) sum += matcher->containsAny((*corpus)[i % CORPUS_SIZE]);
+                    return sum;
+                });
+            } });
+            benchmarks.push_back({ "words/build_" + label, [seed, size] {
+                auto words = std::make_shared<std::vector<std::string>>(CorpusGenerator(seed + 1).dictionary(size));
+                return BenchmarkBody([words](uint64_t n) {
+                    uint64_t sum = 0;
+                    for (uint64_t i = 0; i < n; ++i) sum += WordMatcher(*words).getWordCount();
+                    return sum;
+                });
+            } });
+        }
+    }
+
+    void addGeneratorBenchmarks(std::vector<Benchmark>& benchmarks) {
+        static const size_t LENGTHS[] = { 12, 32 };
+
+        for (size_t length : LENGTHS) {
+            benchmarks.push_back({ "generate/random_" + std::to_string(length), [length] {
+                return BenchmarkBody([length](uint64_t n) {
+                    uint64_t sum = 0;
+                    for (uint64_t i = 0; i < n; ++i) {
+                        sum += static_cast<unsigned char>(Utils::generateRandomPassword(length)[0]);
+                    }
+                    return sum;
+                });
+            } });
+        }
+
+        benchmarks.push_back({ "generate/batch_16", [] {
+            auto generator = std::make_shared<PasswordGenerator>(16);
+            return BenchmarkBody([generator](uint64_t n) {
+                std::string batch = generator->generateBatch(n, ThreadPool::shared());
+                return static_cast<uint64_t>(static_cast<unsigned char>(batch[0]));
+            });
+        } });
+    }
+
+    void addConfigBenchmarks(std::vector<Benchmark>& benchmarks, uint64_t seed) {
+        static const size_t WORD_COUNTS[] = { 1000, 10000, 30000 };
+
+        for (size_t count : WORD_COUNTS) {
+            benchmarks.push_back({ "config/load_" + std::to_string(count) + "_words", [seed, count] {
+                auto file = std::make_shared<TempFile>("config_" + std::to_string(count) + ".cfg");
+                std::ofstream out(file->path(), std::ios::trunc);
+                out << "min_length=8\nmax_length=128\nstrict_mode=false\nmin_entropy_bits=50\n";
+                for (const auto& word : CorpusGenerator(seed + 2).dictionary(count)) out << "common_word=" << word << "\n";
+                out.close();
+                if (!out) throw std::runtime_error("Failed to write " + file->path());
+
+                return BenchmarkBody([file](uint64_t n) {
+                    uint64_t sum = 0;
+                    for (uint64_t i = 0; i < n; ++i) {
+                        ConfigManager loaded;
+                        loaded.loadFromFile(file->path());
+                        sum += loaded.getCommonWords().size();
+                    }
+                    return sum;
+                });
+            } });
+
+            benchmarks.push_back({ "config/load_image_" + std::to_string(count) + "_words", [seed, count] {
+                TempFile source("config_" + std::to_string(count) + "_source.cfg");
+                std::ofstream out(source.path(), std::ios::trunc);
+                for (const auto& word : CorpusGenerator(seed + 2).dictionary(count)) out << "common_word=" << word << "\n";
+                out.close();
+                if (!out) throw std::runtime_error("Failed to write " + source.path());
+
+                auto file = std::make_shared<TempFile>("config_" + std::to_string(count) + ".pwc");
+                if (!ConfigManager(source.path()).compileToFile(file->path())) throw std::runtime_error("Failed to write " + file->path());
+
+                return BenchmarkBody([file](uint64_t n) {
+                    uint64_t sum = 0;
+                    for (uint64_t i = 0; i < n; ++i) {
+                        ConfigManager loaded;
+                        loaded.loadFromFile(file->path());
+                        sum += loaded.getWordMatcher().getWordCount();
+                    }
+                    return sum;
+                });
+            } });
+        }
+
+        // Every word appears twice, in mixed case, so half the lines are duplicates to drop.
+        benchmarks.push_back({ "config/import_200000_lines", [seed] {
+            auto file = std::make_shared<TempFile>("wordlist.txt");
+            std::ofstream out(file->path(), std::ios::trunc);
+            auto words = CorpusGenerator(seed + 2).dictionary(100000);
+            for (const auto& word : words) out << word << "\n";
+            for (auto word : words) {
+                word[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(word[0])));
+                out << word << "\n";
+            }
+            out.close();
+            if (!out) throw std::runtime_error("Failed to write " + file->path());
+
+            return BenchmarkBody([file](uint64_t n) {
+                uint64_t sum = 0;
+                for (uint64_t i = 0; i < n; ++i) {
+                    std::vector<std::string> imported;
+                    sum += WordList::import(file->path(), imported, ThreadPool::shared());
+                }
+                return sum;
+            });
+        } });
+    }
+
+    void addLoggerBenchmarks(std::vector<Benchmark>& benchmarks) {
+        auto body = [](std::shared_ptr<LoggerFixture> fixture) {
+            return BenchmarkBody([fixture](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) fixture->logger.info("Password checked. Strength: Medium");
+                return n;
+            });
+        };
+
+        for (bool timestamp : { true, false }) {
+            benchmarks.push_back({ timestamp ? "logger/info_timestamp" : "logger/info_plain", [timestamp, body] {
+                auto fixture = std::make_shared<LoggerFixture>(timestamp ? "timestamp.log" : "plain.log");
+                fixture->logger.enableTimestamp(timestamp);
+                return body(fixture);
+            } });
+        }
+
+        // With BLOCK the loop runs at the writer thread's pace; with COUNT it shows the caller-side
+        // cost of queueing a message.
+        for (LogOverflowPolicy policy : { LogOverflowPolicy::BLOCK, LogOverflowPolicy::COUNT }) {
+            bool block = policy == LogOverflowPolicy::BLOCK;
+            benchmarks.push_back({ block ? "logger/info_async_block" : "logger/info_async_count", [policy, block, body] {
+                AsyncLogOptions async;
+                async.overflow = policy;
+                return body(std::make_shared<LoggerFixture>(block ? "async_block.log" : "async_count.log", async));
+            } });
+        }
+    }
+
+    void writeCorpus(const BenchmarkOptions& options) {
+        std::ofstream out(options.generate_path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) throw std::runtime_error("Failed to open output: " + options.generate_path);
+        CorpusGenerator generator(options.seed);
+        for (size_t i = 0; i < options.generate_count; ++i) out << generator.next() << '\n';
+        if (!out) throw std::runtime_error("Failed to write output: " + options.generate_path);
+    }
+
+    void printUsage(const char* program) {
+        std::cerr << "Usage: " << program << " [options]\n"
+                  << "  --filter TEXT         only run benchmarks whose name contains TEXT\n"
+                  << "  --min-time SECONDS    minimum duration of one timed run (default 0.2)\n"
+                  << "  --repetitions N       timed runs per benchmark, median is reported (default 5)\n"
+                  << "  --seed N              corpus generator seed (default 1)\n"
+                  << "  --format text|csv     result format (default text)\n"
+                  << "  --list                print benchmark names and exit\n"
+                  << "  --generate N FILE     write N synthetic passwords to FILE and exit\n";
+    }
+
+    bool parseArguments(int argc, char* argv[], BenchmarkOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--filter" && i + 1 < argc) options.filter = argv[++i];
+            else if (arg == "--min-time" && i + 1 < argc) options.min_time = std::stod(argv[++i]);
+            else if (arg == "--repetitions" && i + 1 < argc) options.repetitions = std::max(1, std::stoi(argv[++i]));
+            else if (arg == "--seed" && i + 1 < argc) options.seed = std::stoull(argv[++i]);
+            else if (arg == "--format" && i + 1 < argc) {
+                std::string value = argv[++i];
+                if (value == "text") options.format = OutputFormat::TEXT;
+                else if (value == "csv") options.format = OutputFormat::CSV;
+                else return false;
+            }
+            else if (arg == "--list") options.list_only = true;
+            else if (arg == "--generate" && i + 2 < argc) {
+                options.generate_count = std::stoul(argv[++i]);
+                options.generate_path = argv[++i];
+            }
+            else return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    try {
+        if (!parseArguments(argc, argv, options)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    catch (const std::exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        if (!options.generate_path.empty()) {
+            writeCorpus(options);
+            return 0;
+        }
+
+        ConfigManager config;
+        std::vector<Benchmark> benchmarks;
+        addCheckBenchmarks(benchmarks, config, options.seed);
+        addWordBenchmarks(benchmarks, options.seed);
+        addGeneratorBenchmarks(benchmarks);
+        addConfigBenchmarks(benchmarks, options.seed);
+        addLoggerBenchmarks(benchmarks);
+
+        if (options.format == OutputFormat::CSV) {
+            std::cout << "name,iterations,median_ns,min_ns\n";
+        } else if (!options.list_only) {
+            std::cout << "seed " << options.seed << ", char classes: " << CharClass::implementationName() << "\n";
+            std::printf("%-32s %12s %14s %14s\n", "benchmark", "iterations", "median ns/op", "min ns/op");
+        }
+
+        for (const auto& benchmark : benchmarks) {
+            if (benchmark.name.find(options.filter) == std::string::npos) continue;
+            if (options.list_only) {
+                std::cout << benchmark.name << "\n";
+                continue;
+            }
+
+            BenchmarkResult result = measure(benchmark.setup(), options);
+            if (options.format == OutputFormat::CSV) {
+                std::cout << benchmark.name << ',' << result.iterations << ',' << result.median_ns << ',' << result.min_ns << "\n";
+            } else {
+                std::printf("%-32s %12llu %14.1f %14.1f\n", benchmark.name.c_str(),
+                            static_cast<unsigned long long>(result.iterations), result.median_ns, result.min_ns);
+            }
+            std::cout.flush();
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
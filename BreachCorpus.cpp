@@ -0,0 +1,343 @@
+#include "BreachCorpus.hpp"
+#include "Hash.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+    const char CORPUS_MAGIC[8] = { 'P', 'W', 'B', 'R', 'E', 'A', 'C', 'H' };
+    constexpr uint32_t CORPUS_VERSION = 1;
+    constexpr size_t PREFIX_BYTES = 2;
+    constexpr size_t INDEX_ENTRIES = (size_t(1) << (PREFIX_BYTES * 8)) + 1;
+
+    struct CorpusHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t hash_type;
+        uint32_t hash_size;
+        uint32_t prefix_bytes;
+        uint64_t record_count;
+        uint64_t index_offset;
+        uint64_t records_offset;
+        uint8_t reserved[16];
+    };
+    static_assert(sizeof(CorpusHeader) == 64, "Breach corpus header must stay 64 bytes");
+
+    uint64_t loadBigEndian64(const uint8_t* bytes) {
+        uint64_t value = 0;
+        for (int i = 0; i < 8; ++i) value = (value << 8) | bytes[i];
+        return value;
+    }
+
+    // Holds the sorted runs of a build that did not fit in memory and deletes them when done.
+    class RunFiles {
+    public:
+        explicit RunFiles(const std::string& output_file) : prefix_(output_file + ".run") {}
+
+        ~RunFiles() {
+            for (const std::string& path : paths_) std::remove(path.c_str());
+        }
+
+        RunFiles(const RunFiles&) = delete;
+        RunFiles& operator=(const RunFiles&) = delete;
+
+        const std::string& add() {
+            paths_.push_back(prefix_ + std::to_string(paths_.size()));
+            return paths_.back();
+        }
+
+        const std::vector<std::string>& paths() const {
+            return paths_;
+        }
+
+    private:
+        std::string prefix_;
+        std::vector<std::string> paths_;
+    };
+
+    // Reads one sorted run back a buffer at a time.
+    template <size_t N>
+    class RunReader {
+    public:
+        RunReader(const std::string& path, size_t buffer_records)
+            : in_(path, std::ios::binary), buffer_(buffer_records), position_(0), size_(0) {
+            if (!in_.is_open()) throw std::runtime_error("Failed to reopen sorted run: " + path);
+        }
+
+        const std::array<uint8_t, N>* next() {
+            if (position_ == size_) {
+                in_.read(reinterpret_cast<char*>(buffer_.data()), static_cast<std::streamsize>(buffer_.size() * N));
+                size_ = static_cast<size_t>(in_.gcount()) / N;
+                position_ = 0;
+                if (size_ == 0) return nullptr;
+            }
+            return &buffer_[position_++];
+        }
+
+    private:
+        std::ifstream in_;
+        std::vector<std::array<uint8_t, N>> buffer_;
+        size_t position_;
+        size_t size_;
+    };
+
+    // Writes the records first, counting them per prefix, and the header and index once the
+    // counts are known.
+    class CorpusWriter {
+    public:
+        CorpusWriter(const std::string& output_file, BreachHashType type, size_t hash_size)
+            : output_file_(output_file), out_(output_file, std::ios::binary | std::ios::trunc),
+              index_(INDEX_ENTRIES, 0), hash_size_(hash_size), count_(0) {
+            if (!out_.is_open()) throw std::runtime_error("Failed to create breach corpus: " + output_file);
+            header_ = {};
+            std::memcpy(header_.magic, CORPUS_MAGIC, sizeof(CORPUS_MAGIC));
+            header_.version = CORPUS_VERSION;
+            header_.hash_type = static_cast<uint32_t>(type);
+            header_.hash_size = static_cast<uint32_t>(hash_size);
+            header_.prefix_bytes = static_cast<uint32_t>(PREFIX_BYTES);
+            header_.index_offset = sizeof(CorpusHeader);
+            header_.records_offset = header_.index_offset + INDEX_ENTRIES * sizeof(uint64_t);
+            out_.seekp(static_cast<std::streamoff>(header_.records_offset));
+        }
+
+        void add(const uint8_t* record) {
+            ++index_[((size_t(record[0]) << 8) | record[1]) + 1];
+            out_.write(reinterpret_cast<const char*>(record + PREFIX_BYTES), static_cast<std::streamsize>(hash_size_ - PREFIX_BYTES));
+            ++count_;
+        }
+
+        uint64_t finish() {
+            for (size_t i = 1; i < INDEX_ENTRIES; ++i) index_[i] += index_[i - 1];
+            header_.record_count = count_;
+            out_.seekp(0);
+            out_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+            out_.write(reinterpret_cast<const char*>(index_.data()), index_.size() * sizeof(uint64_t));
+            out_.flush();
+            if (!out_) throw std::runtime_error("Failed to write breach corpus: " + output_file_);
+            return count_;
+        }
+
+    private:
+        std::string output_file_;
+        std::ofstream out_;
+        CorpusHeader header_;
+        std::vector<uint64_t> index_;
+        size_t hash_size_;
+        uint64_t count_;
+    };
+
+    // Sorts the input in runs of at most sort_memory bytes. Input that fits in one run is written
+    // straight out; otherwise every run goes to a temporary file next to the output and the runs
+    // are merged, so a dump of any size is built in bounded memory.
+    template <size_t N>
+    uint64_t writeCorpus(std::istream& input, const std::string& output_file, BreachHashType type, bool plaintext,
+                         size_t sort_memory) {
+        using Record = std::array<uint8_t, N>;
+        const size_t run_records = std::max<size_t>(sort_memory / sizeof(Record), 1);
+        std::vector<Record> records;
+        RunFiles runs(output_file);
+
+        auto sortRun = [&records] {
+            std::sort(records.begin(), records.end());
+            records.erase(std::unique(records.begin(), records.end()), records.end());
+        };
+        auto writeRun = [&] {
+            sortRun();
+            const std::string& path = runs.add();
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * N));
+            if (!out) throw std::runtime_error("Failed to write sorted run: " + path);
+            records.clear();
+        };
+
+        Record record;
+        std::string line;
+        while (std::getline(input, line)) {
+            if (!BreachCorpus::parseLine(line, type, plaintext, record.data())) continue;
+            // Grow by hand so that doubling never takes the buffer past the run size.
+            if (records.size() == records.capacity()) {
+                records.reserve(std::min(std::max<size_t>(records.size() * 2, 1024), run_records));
+            }
+            records.push_back(record);
+            if (records.size() == run_records) writeRun();
+        }
+
+        CorpusWriter writer(output_file, type, N);
+        if (runs.paths().empty()) {
+            sortRun();
+            for (const Record& r : records) writer.add(r.data());
+            return writer.finish();
+        }
+        if (!records.empty()) writeRun();
+        records.clear();
+        records.shrink_to_fit();
+
+        const size_t buffer_records = std::max<size_t>(run_records / runs.paths().size(), 1);
+        std::vector<std::unique_ptr<RunReader<N>>> readers;
+        using Head = std::pair<Record, size_t>;
+        std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+        for (const std::string& path : runs.paths()) {
+            readers.push_back(std::make_unique<RunReader<N>>(path, buffer_records));
+            if (const Record* first = readers.back()->next()) heads.push({ *first, readers.size() - 1 });
+        }
+
+        bool have_last = false;
+        Record last;
+        while (!heads.empty()) {
+            Head head = heads.top();
+            heads.pop();
+            if (!have_last || head.first != last) {
+                writer.add(head.first.data());
+                last = head.first;
+                have_last = true;
+            }
+            if (const Record* next = readers[head.second]->next()) heads.push({ *next, head.second });
+        }
+        return writer.finish();
+    }
+}
+
+BreachCorpus::BreachCorpus(const std::string& filename)
+    : file_(filename, MappedFileAccess::RANDOM) {
+    if (file_.size() < sizeof(CorpusHeader)) throw std::runtime_error("Invalid breach corpus: " + filename);
+
+    CorpusHeader header;
+    std::memcpy(&header, file_.data(), sizeof(header));
+    if (std::memcmp(header.magic, CORPUS_MAGIC, sizeof(CORPUS_MAGIC)) != 0 || header.version != CORPUS_VERSION) {
+        throw std::runtime_error("Unsupported breach corpus format: " + filename);
+    }
+    if (header.hash_type != static_cast<uint32_t>(BreachHashType::SHA1) &&
+        header.hash_type != static_cast<uint32_t>(BreachHashType::NTLM)) {
+        throw std::runtime_error("Unknown hash type in breach corpus: " + filename);
+    }
+
+    hash_type_ = static_cast<BreachHashType>(header.hash_type);
+    hash_size_ = hashSize(hash_type_);
+    record_size_ = hash_size_ - PREFIX_BYTES;
+    record_count_ = header.record_count;
+    if (header.hash_size != hash_size_ || header.prefix_bytes != PREFIX_BYTES ||
+        header.index_offset % sizeof(uint64_t) != 0 ||
+        header.index_offset + INDEX_ENTRIES * sizeof(uint64_t) > file_.size() ||
+        header.records_offset > file_.size() ||
+        record_count_ > (file_.size() - header.records_offset) / record_size_) {
+        throw std::runtime_error("Corrupt breach corpus: " + filename);
+    }
+
+    index_ = reinterpret_cast<const uint64_t*>(file_.data() + header.index_offset);
+    records_ = file_.data() + header.records_offset;
+    // containsHash trusts the index as record bounds, so it must start at zero, never decrease and
+    // end at the record count.
+    bool index_valid = index_[0] == 0 && index_[INDEX_ENTRIES - 1] == record_count_;
+    for (size_t i = 1; i < INDEX_ENTRIES && index_valid; ++i) index_valid = index_[i - 1] <= index_[i];
+    if (!index_valid) throw std::runtime_error("Corrupt breach corpus: " + filename);
+}
+
+BreachHashType BreachCorpus::getHashType() const {
+    return hash_type_;
+}
+
+uint64_t BreachCorpus::getRecordCount() const {
+    return record_count_;
+}
+
+bool BreachCorpus::contains(std::string_view password) const {
+    if (hash_type_ == BreachHashType::SHA1) return containsHash(Hash::sha1(password).data());
+    return containsHash(Hash::ntlm(password).data());
+}
+
+bool BreachCorpus::containsHash(const uint8_t* hash) const {
+    size_t bucket = (size_t(hash[0]) << 8) | hash[1];
+    uint64_t lo = index_[bucket];
+    uint64_t hi = index_[bucket + 1];
+    if (lo >= hi) return false;
+
+    const uint8_t* key = hash + PREFIX_BYTES;
+    auto compare_at = [this, key](uint64_t i) {
+        return std::memcmp(records_ + i * record_size_, key, record_size_);
+    };
+
+    // Hashes are uniform within a bucket, so interpolating on the next eight bytes lands within a
+    // few records of the target; galloping from there keeps the search to one or two pages.
+    double fraction = static_cast<double>(loadBigEndian64(key)) * (1.0 / 18446744073709551616.0);
+    uint64_t guess = lo + static_cast<uint64_t>(fraction * static_cast<double>(hi - lo));
+    if (guess >= hi) guess = hi - 1;
+
+    int cmp = compare_at(guess);
+    if (cmp == 0) return true;
+
+    uint64_t first, last;
+    if (cmp < 0) {
+        first = guess + 1;
+        last = hi;
+        for (uint64_t step = 1; guess + step < hi; step *= 2) {
+            int probe = compare_at(guess + step);
+            if (probe == 0) return true;
+            if (probe > 0) {
+                last = guess + step;
+                break;
+            }
+            first = guess + step + 1;
+        }
+    } else {
+        first = lo;
+        last = guess;
+        for (uint64_t step = 1; step <= guess - lo; step *= 2) {
+            int probe = compare_at(guess - step);
+            if (probe == 0) return true;
+            if (probe < 0) {
+                first = guess - step + 1;
+                break;
+            }
+            last = guess - step;
+        }
+    }
+
+    while (first < last) {
+        uint64_t mid = first + (last - first) / 2;
+        int probe = compare_at(mid);
+        if (probe == 0) return true;
+        if (probe < 0) first = mid + 1;
+        else last = mid;
+    }
+    return false;
+}
+
+uint64_t BreachCorpus::build(std::istream& input, const std::string& output_file,
+                             BreachHashType type, bool plaintext, size_t sort_memory) {
+    if (type == BreachHashType::SHA1) return writeCorpus<20>(input, output_file, type, plaintext, sort_memory);
+    return writeCorpus<16>(input, output_file, type, plaintext, sort_memory);
+}
+
+size_t BreachCorpus::hashSize(BreachHashType type) {
+    return type == BreachHashType::SHA1 ? 20 : 16;
+}
+
+bool BreachCorpus::parseLine(const std::string& line, BreachHashType type, bool plaintext, uint8_t* hash) {
+    size_t length = line.size();
+    if (length > 0 && line[length - 1] == '\r') --length;
+    if (length == 0) return false;
+
+    if (plaintext) {
+        std::string password = line.substr(0, length);
+        if (type == BreachHashType::SHA1) {
+            auto digest = Hash::sha1(password);
+            std::copy(digest.begin(), digest.end(), hash);
+        } else {
+            auto digest = Hash::ntlm(password);
+            std::copy(digest.begin(), digest.end(), hash);
+        }
+        return true;
+    }
+
+    size_t hex_length = hashSize(type) * 2;
+    if (length < hex_length || (length > hex_length && line[hex_length] != ':')) return false;
+    return Hash::parseHex(line.data(), hashSize(type), hash);
+}
\ No newline at end of file
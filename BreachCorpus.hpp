@@ -0,0 +1,50 @@
+#ifndef BREACH_CORPUS_HPP
+#define BREACH_CORPUS_HPP
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <string_view>
+#include "MappedFile.hpp"
+
+enum class BreachHashType : uint32_t {
+    SHA1 = 1,
+    NTLM = 2
+};
+
+// Sorted, prefix-indexed set of breached password hashes, used in place from a memory mapping.
+//
+// File layout: a fixed header, an index of 65537 record offsets keyed by the first two hash
+// bytes, then the sorted records with those two bytes stripped.
+class BreachCorpus {
+public:
+    explicit BreachCorpus(const std::string& filename);
+
+    BreachHashType getHashType() const;
+    uint64_t getRecordCount() const;
+
+    bool contains(std::string_view password) const;
+    bool containsHash(const uint8_t* hash) const;
+
+    static constexpr size_t DEFAULT_SORT_MEMORY = size_t(256) << 20;
+
+    // Reads one hash per line (hex, optionally followed by ":count") or, with plaintext set, one
+    // password per line, and writes a corpus file. Returns the number of unique records written.
+    // Sorting uses about sort_memory bytes; larger inputs are sorted in runs written to temporary
+    // files next to output_file and merged.
+    static uint64_t build(std::istream& input, const std::string& output_file,
+                          BreachHashType type, bool plaintext, size_t sort_memory = DEFAULT_SORT_MEMORY);
+    static size_t hashSize(BreachHashType type);
+    static bool parseLine(const std::string& line, BreachHashType type, bool plaintext, uint8_t* hash);
+
+private:
+    MappedFile file_;
+    BreachHashType hash_type_;
+    size_t hash_size_;
+    size_t record_size_;
+    uint64_t record_count_;
+    const uint64_t* index_;
+    const unsigned char* records_;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "BreachCorpus.hpp"
+#include "BreachFilter.hpp"
+
+namespace {
+    void printUsage(const char* program) {
+        std::cerr << "Usage: " << program << " [--type sha1|ntlm] [--plaintext] [--memory MB] [--filter [--fpr RATE]] <input|-> <output>\n"
+                  << "  Converts a list of hex hashes (optionally \"HASH:count\", one per line) into a\n"
+                  << "  sorted, prefix-indexed breach corpus. With --plaintext the input lines are\n"
+                  << "  passwords and are hashed with the selected algorithm first. --memory caps the\n"
+                  << "  memory used for sorting (default 256 MB); larger inputs are sorted in runs on disk.\n"
+                  << "  With --filter a compact Bloom filter is written instead; --fpr sets its false\n"
+                  << "  positive rate (default 0.01). Filters need a file as input, not stdin.\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    BreachHashType type = BreachHashType::SHA1;
+    bool plaintext = false;
+    bool filter = false;
+    double false_positive_rate = 0.01;
+    size_t sort_memory = BreachCorpus::DEFAULT_SORT_MEMORY;
+    std::string input_path;
+    std::string output_path;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--type" && i + 1 < argc) {
+            std::string value = argv[++i];
+            if (value == "sha1") type = BreachHashType::SHA1;
+            else if (value == "ntlm") type = BreachHashType::NTLM;
+            else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        else if (arg == "--plaintext") plaintext = true;
+        else if (arg == "--filter") filter = true;
+        else if (arg == "--fpr" && i + 1 < argc) false_positive_rate = std::atof(argv[++i]);
+        else if (arg == "--memory" && i + 1 < argc) sort_memory = static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10)) << 20;
+        else if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        else if (input_path.empty()) input_path = arg;
+        else if (output_path.empty()) output_path = arg;
+        else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (input_path.empty() || output_path.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+        uint64_t records = 0;
+        if (input_path == "-") {
+            if (filter) {
+                std::cerr << "Error: --filter needs an input file\n";
+                return 1;
+            }
+            records = BreachCorpus::build(std::cin, output_path, type, plaintext, sort_memory);
+        } else {
+            std::ifstream input(input_path, std::ios::binary);
+            if (!input.is_open()) {
+                std::cerr << "Error: cannot open " << input_path << "\n";
+                return 1;
+            }
+            if (filter) records = BreachFilter::build(input, output_path, type, plaintext, false_positive_rate);
+            else records = BreachCorpus::build(input, output_path, type, plaintext, sort_memory);
+        }
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Wrote " << records << " records to " << output_path << " in " << elapsed << " s\n";
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
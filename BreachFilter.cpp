@@ -0,0 +1,167 @@
+#include "BreachFilter.hpp"
+#include "Hash.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+    const char FILTER_MAGIC[8] = { 'P', 'W', 'B', 'L', 'O', 'O', 'M', '1' };
+    constexpr uint32_t FILTER_VERSION = 1;
+    constexpr size_t BLOCK_WORDS = 8;
+    constexpr uint32_t BLOCK_BITS = BLOCK_WORDS * 64;
+    constexpr uint32_t BITS_PER_PROBE = 9;
+    constexpr uint32_t PROBES_PER_WORD = 64 / BITS_PER_PROBE;
+    // Blocked filters lose a little accuracy against a classic Bloom filter of the same size.
+    constexpr double BLOCKING_OVERHEAD = 1.15;
+
+    struct FilterHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t hash_type;
+        uint32_t hash_count;
+        uint32_t reserved0;
+        uint64_t block_count;
+        uint64_t entry_count;
+        double false_positive_rate;
+        uint8_t reserved[16];
+    };
+    static_assert(sizeof(FilterHeader) == 64, "Breach filter header must stay 64 bytes");
+
+    uint64_t loadLittleEndian64(const uint8_t* bytes) {
+        uint64_t value = 0;
+        for (int i = 7; i >= 0; --i) value = (value << 8) | bytes[i];
+        return value;
+    }
+
+    uint64_t mix64(uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    // Calls visit(word, mask) for each of the hash_count bits a key sets inside its block.
+    template <typename Visit>
+    bool forEachProbe(const uint8_t* hash, uint32_t hash_count, Visit&& visit) {
+        uint64_t seed = loadLittleEndian64(hash + 8);
+        uint64_t bits = seed;
+        for (uint32_t i = 0; i < hash_count; ++i) {
+            if (i != 0 && i % PROBES_PER_WORD == 0) bits = mix64(seed + i);
+            uint32_t bit = static_cast<uint32_t>(bits & (BLOCK_BITS - 1));
+            bits >>= BITS_PER_PROBE;
+            if (!visit(bit >> 6, uint64_t(1) << (bit & 63))) return false;
+        }
+        return true;
+    }
+
+    uint64_t blockFor(const uint8_t* hash, uint64_t block_count) {
+        return loadLittleEndian64(hash) % block_count;
+    }
+}
+
+BreachFilter::BreachFilter(const std::string& filename)
+    : file_(filename, MappedFileAccess::RANDOM) {
+    if (file_.size() < sizeof(FilterHeader)) throw std::runtime_error("Invalid breach filter: " + filename);
+
+    FilterHeader header;
+    std::memcpy(&header, file_.data(), sizeof(header));
+    if (std::memcmp(header.magic, FILTER_MAGIC, sizeof(FILTER_MAGIC)) != 0 || header.version != FILTER_VERSION) {
+        throw std::runtime_error("Unsupported breach filter format: " + filename);
+    }
+    if (header.hash_type != static_cast<uint32_t>(BreachHashType::SHA1) &&
+        header.hash_type != static_cast<uint32_t>(BreachHashType::NTLM)) {
+        throw std::runtime_error("Unknown hash type in breach filter: " + filename);
+    }
+    if (header.block_count == 0 || header.hash_count == 0 ||
+        header.block_count > (file_.size() - sizeof(FilterHeader)) / (BLOCK_WORDS * sizeof(uint64_t))) {
+        throw std::runtime_error("Corrupt breach filter: " + filename);
+    }
+
+    hash_type_ = static_cast<BreachHashType>(header.hash_type);
+    entry_count_ = header.entry_count;
+    false_positive_rate_ = header.false_positive_rate;
+    hash_count_ = header.hash_count;
+    block_count_ = header.block_count;
+    blocks_ = reinterpret_cast<const uint64_t*>(file_.data() + sizeof(FilterHeader));
+}
+
+BreachHashType BreachFilter::getHashType() const {
+    return hash_type_;
+}
+
+uint64_t BreachFilter::getEntryCount() const {
+    return entry_count_;
+}
+
+double BreachFilter::getFalsePositiveRate() const {
+    return false_positive_rate_;
+}
+
+size_t BreachFilter::getSizeBytes() const {
+    return file_.size();
+}
+
+bool BreachFilter::contains(std::string_view password) const {
+    if (hash_type_ == BreachHashType::SHA1) return containsHash(Hash::sha1(password).data());
+    return containsHash(Hash::ntlm(password).data());
+}
+
+bool BreachFilter::containsHash(const uint8_t* hash) const {
+    const uint64_t* block = blocks_ + blockFor(hash, block_count_) * BLOCK_WORDS;
+    return forEachProbe(hash, hash_count_, [block](uint32_t word, uint64_t mask) {
+        return (block[word] & mask) != 0;
+    });
+}
+
+uint64_t BreachFilter::build(std::istream& input, const std::string& output_file, BreachHashType type,
+                             bool plaintext, double false_positive_rate) {
+    if (!(false_positive_rate > 0.0 && false_positive_rate < 1.0)) {
+        throw std::invalid_argument("False positive rate must be between 0 and 1");
+    }
+
+    uint8_t hash[20];
+    std::string line;
+    uint64_t entries = 0;
+    while (std::getline(input, line)) {
+        if (BreachCorpus::parseLine(line, type, plaintext, hash)) ++entries;
+    }
+    input.clear();
+    input.seekg(0);
+    if (!input) throw std::runtime_error("Breach filter input must be a seekable file");
+
+    double bits_per_entry = -std::log(false_positive_rate) / (std::log(2.0) * std::log(2.0)) * BLOCKING_OVERHEAD;
+    uint32_t hash_count = static_cast<uint32_t>(std::max(1.0, std::round(-std::log2(false_positive_rate))));
+    uint64_t block_count = std::max<uint64_t>(1,
+        static_cast<uint64_t>(std::ceil(static_cast<double>(entries) * bits_per_entry / BLOCK_BITS)));
+
+    std::vector<uint64_t> blocks(block_count * BLOCK_WORDS, 0);
+    while (std::getline(input, line)) {
+        if (!BreachCorpus::parseLine(line, type, plaintext, hash)) continue;
+        uint64_t* block = blocks.data() + blockFor(hash, block_count) * BLOCK_WORDS;
+        forEachProbe(hash, hash_count, [block](uint32_t word, uint64_t mask) {
+            block[word] |= mask;
+            return true;
+        });
+    }
+
+    FilterHeader header = {};
+    std::memcpy(header.magic, FILTER_MAGIC, sizeof(FILTER_MAGIC));
+    header.version = FILTER_VERSION;
+    header.hash_type = static_cast<uint32_t>(type);
+    header.hash_count = hash_count;
+    header.block_count = block_count;
+    header.entry_count = entries;
+    header.false_positive_rate = false_positive_rate;
+
+    std::ofstream out(output_file, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) throw std::runtime_error("Failed to create breach filter: " + output_file);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(blocks.data()), blocks.size() * sizeof(uint64_t));
+    if (!out) throw std::runtime_error("Failed to write breach filter: " + output_file);
+    return entries;
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef BREACH_FILTER_HPP
+#define BREACH_FILTER_HPP
+#include <cstdint>
+#include <istream>
+#include <string>
+#include "BreachCorpus.hpp"
+#include "MappedFile.hpp"
+
+// Blocked Bloom filter over breached password hashes for hosts that cannot keep the full corpus.
+// Every key lives in one 64-byte block, so a query costs a single cache miss. Answers may be
+// false positives at the rate chosen when the filter was built, but never false negatives.
+class BreachFilter {
+public:
+    explicit BreachFilter(const std::string& filename);
+
+    BreachHashType getHashType() const;
+    uint64_t getEntryCount() const;
+    double getFalsePositiveRate() const;
+    size_t getSizeBytes() const;
+
+    bool contains(std::string_view password) const;
+    bool containsHash(const uint8_t* hash) const;
+
+    // Reads the same input as BreachCorpus::build. The stream is read twice (once to size the
+    // filter), so it must be seekable. Returns the number of entries inserted.
+    static uint64_t build(std::istream& input, const std::string& output_file, BreachHashType type,
+                          bool plaintext, double false_positive_rate);
+
+private:
+    MappedFile file_;
+    BreachHashType hash_type_;
+    uint64_t entry_count_;
+    double false_positive_rate_;
+    uint32_t hash_count_;
+    uint64_t block_count_;
+    const uint64_t* blocks_;
+};
+
+#endif
\ No newline at end of file
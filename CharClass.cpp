@@ -0,0 +1,422 @@
+#include "CharClass.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CHAR_CLASS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define CHAR_CLASS_TARGET_SSE2
+#define CHAR_CLASS_TARGET_AVX2
+#else
+#define CHAR_CLASS_TARGET_SSE2 __attribute__((target("sse2")))
+#define CHAR_CLASS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+    using ClassifyFunction = uint8_t (*)(const char*, size_t);
+    using ValidateUtf8Function = CharClass::Utf8Status (*)(const char*, size_t);
+
+    // In a range marked CASE_PAIRS, upper and lower case letters alternate, the upper case one at
+    // an even code point (or at an odd one for CASE_PAIRS_ODD).
+    constexpr uint8_t CASE_PAIRS = 1 << 4;
+    constexpr uint8_t CASE_PAIRS_ODD = 1 << 5;
+
+    struct CodePointRange {
+        uint32_t first;
+        uint32_t last;
+        uint8_t classes;
+    };
+
+    using CharClass::UPPER;
+    using CharClass::LOWER;
+    using CharClass::DIGIT;
+    using CharClass::SPECIAL;
+
+    // Sorted by first code point. Code points outside every range belong to no class.
+    constexpr CodePointRange CODE_POINT_RANGES[] = {
+        { 0x00A1, 0x00A9, SPECIAL }, { 0x00AA, 0x00AA, LOWER }, { 0x00AB, 0x00AC, SPECIAL },
+        { 0x00AE, 0x00B4, SPECIAL }, { 0x00B5, 0x00B5, LOWER }, { 0x00B6, 0x00B9, SPECIAL },
+        { 0x00BA, 0x00BA, LOWER }, { 0x00BB, 0x00BF, SPECIAL }, { 0x00C0, 0x00D6, UPPER },
+        { 0x00D7, 0x00D7, SPECIAL }, { 0x00D8, 0x00DE, UPPER }, { 0x00DF, 0x00F6, LOWER },
+        { 0x00F7, 0x00F7, SPECIAL }, { 0x00F8, 0x00FF, LOWER },
+        // Latin Extended-A and B
+        { 0x0100, 0x0137, CASE_PAIRS }, { 0x0138, 0x0138, LOWER }, { 0x0139, 0x0148, CASE_PAIRS_ODD },
+        { 0x0149, 0x0149, LOWER }, { 0x014A, 0x0177, CASE_PAIRS }, { 0x0178, 0x0178, UPPER },
+        { 0x0179, 0x017E, CASE_PAIRS_ODD }, { 0x017F, 0x017F, LOWER }, { 0x01CD, 0x01DC, CASE_PAIRS_ODD },
+        { 0x0200, 0x0233, CASE_PAIRS }, { 0x0250, 0x02AF, LOWER },
+        // Greek
+        { 0x0370, 0x0373, CASE_PAIRS }, { 0x0376, 0x0377, CASE_PAIRS }, { 0x037B, 0x037D, LOWER },
+        { 0x037E, 0x037E, SPECIAL }, { 0x037F, 0x037F, UPPER }, { 0x0386, 0x0386, UPPER },
+        { 0x0387, 0x0387, SPECIAL }, { 0x0388, 0x038A, UPPER }, { 0x038C, 0x038C, UPPER },
+        { 0x038E, 0x038F, UPPER }, { 0x0390, 0x0390, LOWER }, { 0x0391, 0x03A1, UPPER },
+        { 0x03A3, 0x03AB, UPPER }, { 0x03AC, 0x03CE, LOWER }, { 0x03CF, 0x03CF, UPPER },
+        { 0x03D0, 0x03D1, LOWER }, { 0x03D2, 0x03D4, UPPER }, { 0x03D5, 0x03D7, LOWER },
+        { 0x03D8, 0x03EF, CASE_PAIRS }, { 0x03F0, 0x03F3, LOWER }, { 0x03F4, 0x03F4, UPPER },
+        { 0x03F5, 0x03F5, LOWER }, { 0x03F6, 0x03F6, SPECIAL }, { 0x03F7, 0x03F8, CASE_PAIRS_ODD },
+        { 0x03F9, 0x03FA, UPPER }, { 0x03FB, 0x03FC, LOWER }, { 0x03FD, 0x03FF, UPPER },
+        // Cyrillic and Cyrillic Supplement
+        { 0x0400, 0x042F, UPPER }, { 0x0430, 0x045F, LOWER }, { 0x0460, 0x0481, CASE_PAIRS },
+        { 0x0482, 0x0482, SPECIAL }, { 0x048A, 0x04BF, CASE_PAIRS }, { 0x04C0, 0x04C0, UPPER },
+        { 0x04C1, 0x04CE, CASE_PAIRS_ODD }, { 0x04CF, 0x04CF, LOWER }, { 0x04D0, 0x052F, CASE_PAIRS },
+        // Armenian
+        { 0x0531, 0x0556, UPPER }, { 0x055A, 0x055F, SPECIAL }, { 0x0560, 0x0588, LOWER },
+        { 0x0589, 0x058A, SPECIAL },
+        // Arabic, Devanagari and Thai punctuation and digits
+        { 0x060C, 0x060D, SPECIAL }, { 0x061B, 0x061B, SPECIAL }, { 0x061F, 0x061F, SPECIAL },
+        { 0x0660, 0x0669, DIGIT }, { 0x066A, 0x066D, SPECIAL }, { 0x06D4, 0x06D4, SPECIAL },
+        { 0x06F0, 0x06F9, DIGIT }, { 0x0964, 0x0965, SPECIAL }, { 0x0966, 0x096F, DIGIT },
+        { 0x0970, 0x0970, SPECIAL }, { 0x0E50, 0x0E59, DIGIT },
+        // Georgian, Cyrillic Extended-C, Latin Extended Additional
+        { 0x10A0, 0x10C5, UPPER }, { 0x10D0, 0x10FA, LOWER }, { 0x1C80, 0x1C88, LOWER },
+        { 0x1E00, 0x1E95, CASE_PAIRS }, { 0x1E96, 0x1E9D, LOWER }, { 0x1E9E, 0x1E9E, UPPER },
+        { 0x1E9F, 0x1E9F, LOWER }, { 0x1EA0, 0x1EFF, CASE_PAIRS },
+        // General punctuation, currency, arrows, mathematical operators, shapes and dingbats
+        { 0x2010, 0x2027, SPECIAL }, { 0x2030, 0x205E, SPECIAL }, { 0x20A0, 0x20C0, SPECIAL },
+        { 0x2190, 0x2426, SPECIAL }, { 0x2440, 0x244A, SPECIAL }, { 0x2460, 0x2BFF, SPECIAL },
+        // CJK punctuation, Cyrillic Extended-B, fullwidth forms
+        { 0x3001, 0x3003, SPECIAL }, { 0x3008, 0x3020, SPECIAL }, { 0xA640, 0xA66D, CASE_PAIRS },
+        { 0xA680, 0xA69B, CASE_PAIRS }, { 0xFF01, 0xFF0F, SPECIAL }, { 0xFF10, 0xFF19, DIGIT },
+        { 0xFF1A, 0xFF20, SPECIAL }, { 0xFF21, 0xFF3A, UPPER }, { 0xFF3B, 0xFF40, SPECIAL },
+        { 0xFF41, 0xFF5A, LOWER }, { 0xFF5B, 0xFF65, SPECIAL }, { 0xFFE0, 0xFFEE, SPECIAL },
+        // Emoji and other pictographs
+        { 0x1F000, 0x1FAFF, SPECIAL }
+    };
+
+    constexpr uint8_t classesIn(const CodePointRange& range, uint32_t code_point) {
+        if (range.classes == CASE_PAIRS) return (code_point & 1) == 0 ? UPPER : LOWER;
+        if (range.classes == CASE_PAIRS_ODD) return (code_point & 1) != 0 ? UPPER : LOWER;
+        return range.classes;
+    }
+
+    constexpr std::array<uint8_t, 0x800> makeTwoByteTable() {
+        std::array<uint8_t, 0x800> table{};
+        for (uint32_t c = 0; c < 0x80; ++c) table[c] = CharClass::TABLE[c];
+        for (const CodePointRange& range : CODE_POINT_RANGES) {
+            for (uint32_t c = range.first; c <= range.last && c < table.size(); ++c) table[c] = classesIn(range, c);
+        }
+        return table;
+    }
+
+    CharClass::Utf8Status validateUtf8Scalar(const char* data, size_t size) {
+        const unsigned char* it = reinterpret_cast<const unsigned char*>(data);
+        const unsigned char* end = it + size;
+        bool ascii = true;
+        while (it < end) {
+            unsigned char lead = *it;
+            if (lead < 0x80) {
+                ++it;
+                continue;
+            }
+            ascii = false;
+            // The second byte of a sequence has a narrower range after the leads that could start
+            // an overlong form, a surrogate or a code point above U+10FFFF.
+            size_t continuations;
+            unsigned char low = 0x80, high = 0xBF;
+            if (lead >= 0xC2 && lead <= 0xDF) continuations = 1;
+            else if (lead >= 0xE0 && lead <= 0xEF) {
+                continuations = 2;
+                if (lead == 0xE0) low = 0xA0;
+                else if (lead == 0xED) high = 0x9F;
+            }
+            else if (lead >= 0xF0 && lead <= 0xF4) {
+                continuations = 3;
+                if (lead == 0xF0) low = 0x90;
+                else if (lead == 0xF4) high = 0x8F;
+            }
+            else return CharClass::Utf8Status::INVALID;
+
+            if (static_cast<size_t>(end - it) <= continuations || it[1] < low || it[1] > high) {
+                return CharClass::Utf8Status::INVALID;
+            }
+            for (size_t i = 2; i <= continuations; ++i) {
+                if ((it[i] & 0xC0) != 0x80) return CharClass::Utf8Status::INVALID;
+            }
+            it += continuations + 1;
+        }
+        return ascii ? CharClass::Utf8Status::ASCII : CharClass::Utf8Status::VALID;
+    }
+
+    uint8_t classifyScalar(const char* data, size_t size) {
+        uint8_t classes = 0;
+        for (size_t i = 0; i < size; ++i) classes |= CharClass::of(static_cast<unsigned char>(data[i]));
+        return classes;
+    }
+
+#ifdef CHAR_CLASS_X86
+    // Each class is a byte range [lo, hi]: x is inside when (x - lo) wraps to at most (hi - lo),
+    // which SSE2 can test with an unsigned min and an equality compare. Special characters are
+    // the printable range minus letters and digits.
+    struct ClassMasks {
+        unsigned upper;
+        unsigned lower;
+        unsigned digit;
+        unsigned special;
+    };
+
+    CHAR_CLASS_TARGET_SSE2
+    inline unsigned inRange16(__m128i bytes, char lo, char hi) {
+        __m128i shifted = _mm_sub_epi8(bytes, _mm_set1_epi8(lo));
+        __m128i inside = _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(static_cast<char>(hi - lo))), shifted);
+        return static_cast<unsigned>(_mm_movemask_epi8(inside));
+    }
+
+    CHAR_CLASS_TARGET_SSE2
+    inline void accumulate16(__m128i bytes, ClassMasks& masks) {
+        unsigned upper = inRange16(bytes, 'A', 'Z');
+        unsigned lower = inRange16(bytes, 'a', 'z');
+        unsigned digit = inRange16(bytes, '0', '9');
+        masks.upper |= upper;
+        masks.lower |= lower;
+        masks.digit |= digit;
+        masks.special |= inRange16(bytes, 0x21, 0x7E) & ~(upper | lower | digit);
+    }
+
+    uint8_t toClasses(const ClassMasks& masks) {
+        uint8_t classes = 0;
+        if (masks.upper) classes |= CharClass::UPPER;
+        if (masks.lower) classes |= CharClass::LOWER;
+        if (masks.digit) classes |= CharClass::DIGIT;
+        if (masks.special) classes |= CharClass::SPECIAL;
+        return classes;
+    }
+
+    CHAR_CLASS_TARGET_SSE2
+    uint8_t classifySse2(const char* data, size_t size) {
+        ClassMasks masks = { 0, 0, 0, 0 };
+        size_t i = 0;
+        for (; i + 16 <= size; i += 16) {
+            accumulate16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), masks);
+        }
+        if (i < size) {
+            // Zero padding belongs to no class, so the tail can go through the same path.
+            alignas(16) char tail[16] = {};
+            std::memcpy(tail, data + i, size - i);
+            accumulate16(_mm_load_si128(reinterpret_cast<const __m128i*>(tail)), masks);
+        }
+        return toClasses(masks);
+    }
+
+    // Skips the leading run of ASCII blocks; no sequence can start before the first other byte.
+    CHAR_CLASS_TARGET_SSE2
+    CharClass::Utf8Status validateUtf8Sse2(const char* data, size_t size) {
+        size_t i = 0;
+        while (i + 16 <= size && _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i))) == 0) {
+            i += 16;
+        }
+        return validateUtf8Scalar(data + i, size - i);
+    }
+
+    CHAR_CLASS_TARGET_AVX2
+    inline unsigned inRange32(__m256i bytes, char lo, char hi) {
+        __m256i shifted = _mm256_sub_epi8(bytes, _mm256_set1_epi8(lo));
+        __m256i inside = _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(static_cast<char>(hi - lo))), shifted);
+        return static_cast<unsigned>(_mm256_movemask_epi8(inside));
+    }
+
+    CHAR_CLASS_TARGET_AVX2
+    uint8_t classifyAvx2(const char* data, size_t size) {
+        // A single SSE2 block already covers typical passwords; AVX2 only pays off past that.
+        if (size <= 16) return classifySse2(data, size);
+
+        ClassMasks masks = { 0, 0, 0, 0 };
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32) {
+            __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            unsigned upper = inRange32(bytes, 'A', 'Z');
+            unsigned lower = inRange32(bytes, 'a', 'z');
+            unsigned digit = inRange32(bytes, '0', '9');
+            masks.upper |= upper;
+            masks.lower |= lower;
+            masks.digit |= digit;
+            masks.special |= inRange32(bytes, 0x21, 0x7E) & ~(upper | lower | digit);
+        }
+        uint8_t classes = toClasses(masks);
+        if (i < size) classes |= classifySse2(data + i, size - i);
+        return classes;
+    }
+
+    // The lookup algorithm of Keiser and Lemire ("Validating UTF-8 in less than one instruction
+    // per byte", 2021). Three 16-entry tables, indexed by the high and low nibble of the previous
+    // byte and the high nibble of the current one, each give the set of errors the pair could be
+    // part of; a pair is invalid when all three agree. Third and fourth bytes of a sequence are
+    // checked separately by looking two and three bytes back.
+    constexpr uint8_t TOO_SHORT = 1 << 0;
+    constexpr uint8_t TOO_LONG = 1 << 1;
+    constexpr uint8_t OVERLONG_3 = 1 << 2;
+    constexpr uint8_t TOO_LARGE = 1 << 3;
+    constexpr uint8_t SURROGATE = 1 << 4;
+    constexpr uint8_t OVERLONG_2 = 1 << 5;
+    constexpr uint8_t TOO_LARGE_1000 = 1 << 6;
+    constexpr uint8_t OVERLONG_4 = 1 << 6;
+    constexpr uint8_t TWO_CONTS = 1 << 7;
+    constexpr uint8_t CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+    CHAR_CLASS_TARGET_AVX2
+    inline __m256i lookup16(__m256i indices, const uint8_t (&table)[16]) {
+        __m128i lane = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table));
+        return _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(lane), indices);
+    }
+
+    CHAR_CLASS_TARGET_AVX2
+    inline __m256i highNibbles(__m256i bytes) {
+        return _mm256_and_si256(_mm256_srli_epi16(bytes, 4), _mm256_set1_epi8(0x0F));
+    }
+
+    // The bytes N positions before each byte of input, reaching back into previous.
+    template <int N>
+    CHAR_CLASS_TARGET_AVX2
+    inline __m256i earlierBytes(__m256i input, __m256i previous) {
+        return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(previous, input, 0x21), 16 - N);
+    }
+
+    CHAR_CLASS_TARGET_AVX2
+    inline __m256i utf8Errors(__m256i input, __m256i previous) {
+        static const uint8_t BYTE_1_HIGH[16] = {
+            TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+            TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+            TOO_SHORT | OVERLONG_2,
+            TOO_SHORT,
+            TOO_SHORT | OVERLONG_3 | SURROGATE,
+            TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+        };
+        static const uint8_t BYTE_1_LOW[16] = {
+            CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+            CARRY | OVERLONG_2,
+            CARRY,
+            CARRY,
+            CARRY | TOO_LARGE,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000
+        };
+        static const uint8_t BYTE_2_HIGH[16] = {
+            TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+            TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+        };
+
+        __m256i prev1 = earlierBytes<1>(input, previous);
+        __m256i special = _mm256_and_si256(
+            _mm256_and_si256(lookup16(highNibbles(prev1), BYTE_1_HIGH),
+                             lookup16(_mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)), BYTE_1_LOW)),
+            lookup16(highNibbles(input), BYTE_2_HIGH));
+
+        // Only 111xxxxx two bytes back or 1111xxxx three bytes back leave the high bit set.
+        __m256i third = _mm256_subs_epu8(earlierBytes<2>(input, previous), _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+        __m256i fourth = _mm256_subs_epu8(earlierBytes<3>(input, previous), _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+        __m256i must_continue = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+        return _mm256_xor_si256(must_continue, special);
+    }
+
+    CHAR_CLASS_TARGET_AVX2
+    CharClass::Utf8Status validateUtf8Avx2(const char* data, size_t size) {
+        __m256i errors = _mm256_setzero_si256();
+        __m256i high_bits = _mm256_setzero_si256();
+        __m256i previous = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32) {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            high_bits = _mm256_or_si256(high_bits, input);
+            errors = _mm256_or_si256(errors, utf8Errors(input, previous));
+            previous = input;
+        }
+        // The zero padding after the last byte (a whole block of it when size is a multiple of 32)
+        // makes a truncated final sequence show up as TOO_SHORT.
+        alignas(32) char tail[32] = {};
+        std::memcpy(tail, data + i, size - i);
+        __m256i input = _mm256_load_si256(reinterpret_cast<const __m256i*>(tail));
+        high_bits = _mm256_or_si256(high_bits, input);
+        errors = _mm256_or_si256(errors, utf8Errors(input, previous));
+
+        if (!_mm256_testz_si256(errors, errors)) return CharClass::Utf8Status::INVALID;
+        return _mm256_movemask_epi8(high_bits) == 0 ? CharClass::Utf8Status::ASCII : CharClass::Utf8Status::VALID;
+    }
+
+    bool cpuHasAvx2() {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+    bool cpuHasSse2() {
+#if defined(__x86_64__) || defined(_M_X64)
+        return true;
+#elif defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        return (info[3] & (1 << 26)) != 0;
+#else
+        return __builtin_cpu_supports("sse2");
+#endif
+    }
+#endif
+
+    struct Implementation {
+        ClassifyFunction function;
+        ValidateUtf8Function validate_utf8;
+        const char* name;
+    };
+
+    Implementation selectImplementation() {
+#ifdef CHAR_CLASS_X86
+        if (cpuHasAvx2()) return { classifyAvx2, validateUtf8Avx2, "avx2" };
+        if (cpuHasSse2()) return { classifySse2, validateUtf8Sse2, "sse2" };
+#endif
+        return { classifyScalar, validateUtf8Scalar, "scalar" };
+    }
+
+    const Implementation& implementation() {
+        static const Implementation selected = selectImplementation();
+        return selected;
+    }
+}
+
+namespace CharClass {
+    const std::array<uint8_t, 0x800> TWO_BYTE_TABLE = makeTwoByteTable();
+
+    uint8_t ofWideCodePoint(uint32_t code_point) {
+        const CodePointRange* end = std::end(CODE_POINT_RANGES);
+        const CodePointRange* range = std::upper_bound(std::begin(CODE_POINT_RANGES), end, code_point,
+            [](uint32_t value, const CodePointRange& candidate) { return value < candidate.first; });
+        if (range == std::begin(CODE_POINT_RANGES)) return 0;
+        --range;
+        return code_point <= range->last ? classesIn(*range, code_point) : 0;
+    }
+
+    Utf8Status validateUtf8(const char* data, size_t size) {
+        return implementation().validate_utf8(data, size);
+    }
+
+    uint8_t classify(const char* data, size_t size) {
+        return implementation().function(data, size);
+    }
+
+    const char* implementationName() {
+        return implementation().name;
+    }
+}
\ No newline at end of file
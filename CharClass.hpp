@@ -0,0 +1,88 @@
+#ifndef CHAR_CLASS_HPP
+#define CHAR_CLASS_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// How password text is read. BYTES treats every byte as a character, so only printable ASCII has a
+// class; UTF8 decodes the text and classifies and counts code points, falling back to bytes for
+// text that is not valid UTF-8.
+enum class TextEncoding {
+    BYTES,
+    UTF8
+};
+
+// Character classes as the "C" locale isupper/islower/isdigit/ispunct see them. Bytes outside
+// printable ASCII (space, control characters, UTF-8 sequences) belong to no class; decoded code
+// points can be classified with ofCodePoint instead.
+namespace CharClass {
+    enum : uint8_t {
+        UPPER = 1 << 0,
+        LOWER = 1 << 1,
+        DIGIT = 1 << 2,
+        SPECIAL = 1 << 3
+    };
+
+    constexpr std::array<uint8_t, 256> makeTable() {
+        std::array<uint8_t, 256> table{};
+        for (int c = 0; c < 256; ++c) {
+            if (c >= 'A' && c <= 'Z') table[c] = UPPER;
+            else if (c >= 'a' && c <= 'z') table[c] = LOWER;
+            else if (c >= '0' && c <= '9') table[c] = DIGIT;
+            else if (c >= 0x21 && c <= 0x7E) table[c] = SPECIAL;
+        }
+        return table;
+    }
+
+    inline constexpr std::array<uint8_t, 256> TABLE = makeTable();
+
+    inline uint8_t of(unsigned char c) {
+        return TABLE[c];
+    }
+
+    // Classes of the code points below U+0800, which covers Latin, Greek and Cyrillic.
+    extern const std::array<uint8_t, 0x800> TWO_BYTE_TABLE;
+
+    uint8_t ofWideCodePoint(uint32_t code_point);
+
+    // Cased letters of the Latin, Greek, Cyrillic, Armenian and Georgian scripts are UPPER or LOWER,
+    // decimal digits of any script are DIGIT, and punctuation and symbols (emoji included) are
+    // SPECIAL. Letters of scripts without case belong to no class.
+    inline uint8_t ofCodePoint(uint32_t code_point) {
+        return code_point < TWO_BYTE_TABLE.size() ? TWO_BYTE_TABLE[code_point] : ofWideCodePoint(code_point);
+    }
+
+    enum class Utf8Status {
+        ASCII,
+        VALID,
+        INVALID
+    };
+
+    // Checks that data is well-formed UTF-8: no overlong forms, surrogates, code points above
+    // U+10FFFF or truncated sequences. ASCII means every byte is below 0x80. Uses AVX2 when the CPU
+    // has it.
+    Utf8Status validateUtf8(const char* data, size_t size);
+
+    // Decodes the code point at it and moves it past it. Only for text validateUtf8 accepted.
+    inline uint32_t decodeUtf8(const unsigned char*& it) {
+        uint32_t lead = *it++;
+        if (lead < 0x80) return lead;
+        if (lead < 0xE0) return ((lead & 0x1F) << 6) | (*it++ & 0x3Fu);
+        if (lead < 0xF0) {
+            uint32_t code_point = ((lead & 0x0F) << 12) | ((it[0] & 0x3Fu) << 6) | (it[1] & 0x3Fu);
+            it += 2;
+            return code_point;
+        }
+        uint32_t code_point = ((lead & 0x07) << 18) | ((it[0] & 0x3Fu) << 12) | ((it[1] & 0x3Fu) << 6) | (it[2] & 0x3Fu);
+        it += 3;
+        return code_point;
+    }
+
+    // Union of the classes of every byte in data. Uses AVX2 or SSE2 when the CPU has them and a
+    // table loop otherwise; the choice is made once, on first call.
+    uint8_t classify(const char* data, size_t size);
+
+    const char* implementationName();
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "ConfigManager.hpp"
+
+namespace {
+    void printUsage(const char* program) {
+        std::cerr << "Usage: " << program << " <config> <output>\n"
+                  << "  Loads a text configuration (key=value lines, as written by saveToFile) on top\n"
+                  << "  of the defaults and writes it, word matcher included, as a binary image.\n"
+                  << "  Point --config or the app at the image to skip parsing and matcher\n"
+                  << "  construction at startup; it is mapped and used in place.\n";
+    }
+
+    double secondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 2 && (std::string(argv[1]) == "--help" || std::string(argv[1]) == "-h")) {
+        printUsage(argv[0]);
+        return 0;
+    }
+    if (argc != 3) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    std::string input_path = argv[1];
+    std::string output_path = argv[2];
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+        ConfigManager config(input_path);
+        double parse_seconds = secondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        if (!config.compileToFile(output_path)) {
+            std::cerr << "Error: cannot write " << output_path << "\n";
+            return 1;
+        }
+        double write_seconds = secondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        ConfigManager compiled(output_path);
+        double load_seconds = secondsSince(start);
+
+        std::cout << "Compiled " << compiled.getWordMatcher().getWordCount() << " words into " << output_path
+                  << " (parsed in " << parse_seconds << " s, written in " << write_seconds
+                  << " s, loads in " << load_seconds * 1000.0 << " ms)\n";
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -1,140 +1,555 @@
-#include "ConfigManager.hpp"
-#include <fstream>
-#include <sstream>
-#include <algorithm>
-#include <stdexcept>
-
-ConfigManager::ConfigManager() {
-    initializeDefaults();
-}
-
-ConfigManager::ConfigManager(const std::string& config_file) {
-    initializeDefaults();
-    if (!loadFromFile(config_file)) {
-        throw std::runtime_error("Failed to load configuration from file: " + config_file);
-    }
-}
-
-void ConfigManager::initializeDefaults() {
-    min_length_ = 8;
-    max_length_ = 128;
-    strict_mode_ = false;
-    min_entropy_bits_ = 50;
-    
-    common_words_ = {
-        "password", "admin", "user", "login", "123456", "qwerty", "abc123",
-        "letmein", "welcome", "monkey", "dragon", "baseball", "football",
-        "superman", "batman", "trustno1", "sunshine", "princess", "freedom",
-        "shadow", "master", "michael", "jennifer", "hunter", "buster",
-        "thomas", "robert", "soccer", "hockey", "killer", "george",
-        "charlie", "andrew", "michelle", "jordan", "taylor", "steven",
-        "richard", "maggie", "pepper", "cheese", "david", "lucky",
-        "flower", "angel", "tigger", "homer", "james", "johnny"
-    };
-}
-
-size_t ConfigManager::getMinLength() const {
-    return min_length_;
-}
-
-size_t ConfigManager::getMaxLength() const {
-    return max_length_;
-}
-
-const std::vector<std::string>& ConfigManager::getCommonWords() const {
-    return common_words_;
-}
-
-bool ConfigManager::isStrictMode() const {
-    return strict_mode_;
-}
-
-int ConfigManager::getMinEntropyBits() const {
-    return min_entropy_bits_;
-}
-
-void ConfigManager::setMinLength(size_t length) {
-    if (length > max_length_) throw std::invalid_argument("Minimum length cannot be greater than maximum length");
-    min_length_ = length;
-}
-
-void ConfigManager::setMaxLength(size_t length) {
-    if (length < min_length_) throw std::invalid_argument("Maximum length cannot be less than minimum length");
-    max_length_ = length;
-}
-
-void ConfigManager::setStrictMode(bool strict) {
-    strict_mode_ = strict;
-}
-
-void ConfigManager::setMinEntropyBits(int bits) {
-    if (bits < 0) throw std::invalid_argument("Minimum entropy bits cannot be negative");
-    min_entropy_bits_ = bits;
-}
-
-void ConfigManager::addCommonWord(const std::string& word) {
-    if (std::find(common_words_.begin(), common_words_.end(), word) == common_words_.end()) {
-        common_words_.push_back(word);
-    }
-}
-
-void ConfigManager::removeCommonWord(const std::string& word) {
-    common_words_.erase(
-        std::remove(common_words_.begin(), common_words_.end(), word),
-        common_words_.end()
-    );
-}
-
-bool ConfigManager::loadFromFile(const std::string& filename) {
-    try {
-        std::ifstream file(filename);
-        if (!file.is_open()) return false;
-
-        std::string line;
-        while (std::getline(file, line)) {
-            if (line.empty() || line[0] == '#') continue;
-            
-            std::istringstream iss(line);
-            std::string key;
-            if (std::getline(iss, key, '=')) {
-                std::string value;
-                if (std::getline(iss, value)) {
-                    if (key == "min_length") setMinLength(std::stoi(value));
-                    else if (key == "max_length") setMaxLength(std::stoi(value));
-                    else if (key == "strict_mode") setStrictMode(value == "true" || value == "1");
-                    else if (key == "min_entropy_bits") setMinEntropyBits(std::stoi(value));
-                    else if (key == "common_word") addCommonWord(value);
-                }
-            }
-        }
-        return true;
-    }
-    catch (const std::exception& e) {
-        return false;
-    }
-}
-
-bool ConfigManager::saveToFile(const std::string& filename) const {
-    try {
-        std::ofstream file(filename);
-        if (!file.is_open()) return false;
-
-        file << "min_length=" << min_length_ << "\n";
-        file << "max_length=" << max_length_ << "\n";
-        file << "strict_mode=" << (strict_mode_ ? "true" : "false") << "\n";
-        file << "min_entropy_bits=" << min_entropy_bits_ << "\n";
-
-        for (const auto& word : common_words_) {
-            file << "common_word=" << word << "\n";
-        }
-        
-        return true;
-    }
-    catch (const std::exception& e) {
-        return false;
-    }
-}
-
-void ConfigManager::resetToDefaults() {
-    initializeDefaults();
+#include "ConfigManager.hpp"
+#include "Hash.hpp"
+#include "MappedFile.hpp"
+#include "ThreadPool.hpp"
+#include "WordList.hpp"
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+#include <atomic>
+#include <mutex>
+
+namespace {
+    // Shared by every instance, so two configurations have the same generation only when one is an
+    // unchanged copy of the other.
+    uint64_t nextGeneration() {
+        static std::atomic<uint64_t> counter(0);
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    const char IMAGE_MAGIC[8] = { 'P', 'W', 'C', 'O', 'N', 'F', 'I', 'G' };
+    constexpr uint32_t IMAGE_VERSION = 2;
+    constexpr size_t IMAGE_ALIGNMENT = 8;
+
+    enum ImageSectionId : uint32_t {
+        SECTION_BREACH_CORPUS_PATH,
+        SECTION_BREACH_FILTER_PATH,
+        SECTION_MARKOV_MODEL_PATH,
+        SECTION_WORD_OFFSETS,
+        SECTION_WORD_CHARS,
+        SECTION_WORD_MATCHER,
+        SECTION_COUNT
+    };
+
+    // The checksum covers every byte after this header, settings and section table included.
+    struct ImageHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t section_count;
+        uint64_t file_size;
+        uint64_t checksum;
+        uint8_t reserved[32];
+    };
+    static_assert(sizeof(ImageHeader) == 64, "Configuration image header must stay 64 bytes");
+
+    struct ImageSettings {
+        uint64_t min_length;
+        uint64_t max_length;
+        int32_t min_entropy_bits;
+        uint32_t strict_mode;
+        uint32_t scoring_mode;
+        uint32_t text_encoding;
+    };
+
+    struct ImageSection {
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    constexpr size_t IMAGE_PREFIX_BYTES = sizeof(ImageHeader) + sizeof(ImageSettings) + SECTION_COUNT * sizeof(ImageSection);
+}
+
+// The original spelling of every word, kept for getCommonWords and saveToFile. Loading an image
+// only records where the words are; the strings are built the first time the list is needed.
+struct ConfigManager::ImageWords {
+    std::shared_ptr<const MappedFile> file;
+    const uint32_t* offsets;
+    const char* chars;
+    size_t count;
+    mutable std::once_flag built;
+    mutable std::vector<std::string> words;
+
+    const std::vector<std::string>& list() const {
+        std::call_once(built, [this] {
+            words.reserve(count);
+            for (size_t i = 0; i < count; ++i) words.emplace_back(chars + offsets[i], offsets[i + 1] - offsets[i]);
+        });
+        return words;
+    }
+};
+
+ConfigManager::ConfigManager() {
+    initializeDefaults();
+}
+
+ConfigManager::ConfigManager(const std::string& config_file) {
+    initializeDefaults();
+    if (!loadFromFile(config_file)) {
+        throw std::runtime_error("Failed to load configuration from file: " + config_file);
+    }
+}
+
+void ConfigManager::initializeDefaults() {
+    min_length_ = 8;
+    max_length_ = 128;
+    strict_mode_ = false;
+    min_entropy_bits_ = 50;
+    breach_corpus_path_.clear();
+    breach_corpus_.reset();
+    breach_filter_path_.clear();
+    breach_filter_.reset();
+    markov_model_path_.clear();
+    markov_model_.reset();
+    scoring_mode_ = ScoringMode::CHECKLIST;
+    text_encoding_ = TextEncoding::BYTES;
+    
+    image_words_.reset();
+    common_words_ = {
+        "password", "admin", "user", "login", "123456", "qwerty", "abc123",
+        "letmein", "welcome", "monkey", "dragon", "baseball", "football",
+        "superman", "batman", "trustno1", "sunshine", "princess", "freedom",
+        "shadow", "master", "michael", "jennifer", "hunter", "buster",
+        "thomas", "robert", "soccer", "hockey", "killer", "george",
+        "charlie", "andrew", "michelle", "jordan", "taylor", "steven",
+        "richard", "maggie", "pepper", "cheese", "david", "lucky",
+        "flower", "angel", "tigger", "homer", "james", "johnny"
+    };
+    rebuildWordMatcher();
+}
+
+size_t ConfigManager::getMinLength() const {
+    return min_length_;
+}
+
+size_t ConfigManager::getMaxLength() const {
+    return max_length_;
+}
+
+const std::vector<std::string>& ConfigManager::getCommonWords() const {
+    return image_words_ ? image_words_->list() : common_words_;
+}
+
+const std::string& ConfigManager::getBreachCorpusPath() const {
+    return breach_corpus_path_;
+}
+
+const BreachCorpus* ConfigManager::getBreachCorpus() const {
+    return breach_corpus_.get();
+}
+
+const std::string& ConfigManager::getBreachFilterPath() const {
+    return breach_filter_path_;
+}
+
+const BreachFilter* ConfigManager::getBreachFilter() const {
+    return breach_filter_.get();
+}
+
+const std::string& ConfigManager::getMarkovModelPath() const {
+    return markov_model_path_;
+}
+
+const MarkovModel* ConfigManager::getMarkovModel() const {
+    return markov_model_.get();
+}
+
+const WordMatcher& ConfigManager::getWordMatcher() const {
+    return *word_matcher_;
+}
+
+bool ConfigManager::isStrictMode() const {
+    return strict_mode_;
+}
+
+int ConfigManager::getMinEntropyBits() const {
+    return min_entropy_bits_;
+}
+
+ScoringMode ConfigManager::getScoringMode() const {
+    return scoring_mode_;
+}
+
+TextEncoding ConfigManager::getTextEncoding() const {
+    return text_encoding_;
+}
+
+uint64_t ConfigManager::getGeneration() const {
+    return generation_;
+}
+
+void ConfigManager::setMinLength(size_t length) {
+    if (length > max_length_) throw std::invalid_argument("Minimum length cannot be greater than maximum length");
+    min_length_ = length;
+    generation_ = nextGeneration();
+}
+
+void ConfigManager::setMaxLength(size_t length) {
+    if (length < min_length_) throw std::invalid_argument("Maximum length cannot be less than minimum length");
+    max_length_ = length;
+    generation_ = nextGeneration();
+}
+
+void ConfigManager::setStrictMode(bool strict) {
+    strict_mode_ = strict;
+    generation_ = nextGeneration();
+}
+
+void ConfigManager::setMinEntropyBits(int bits) {
+    if (bits < 0) throw std::invalid_argument("Minimum entropy bits cannot be negative");
+    min_entropy_bits_ = bits;
+    generation_ = nextGeneration();
+}
+
+void ConfigManager::setBreachCorpusPath(const std::string& path) {
+    std::shared_ptr<const BreachCorpus> corpus;
+    if (!path.empty()) corpus = std::make_shared<const BreachCorpus>(path);
+    breach_corpus_path_ = path;
+    breach_corpus_ = std::move(corpus);
+    generation_ = nextGeneration();
+}
+
+void ConfigManager::setBreachFilterPath(const std::string& path) {
+    std::shared_ptr<const BreachFilter> filter;
+    if (!path.empty()) filter = std::make_shared<const BreachFilter>(path);
+    breach_filter_path_ = path;
+    breach_filter_ = std::move(filter);
+    generation_ = nextGeneration();
+}
+
+void ConfigManager::setMarkovModelPath(const std::string& path) {
+    std::shared_ptr<const MarkovModel> model;
+    if (!path.empty()) model = std::make_shared<const MarkovModel>(path);
+    markov_model_path_ = path;
+    markov_model_ = std::move(model);
+    generation_ = nextGeneration();
+}
+
+void ConfigManager::setScoringMode(ScoringMode mode) {
+    scoring_mode_ = mode;
+    generation_ = nextGeneration();
+}
+
+void ConfigManager::setTextEncoding(TextEncoding encoding) {
+    text_encoding_ = encoding;
+    generation_ = nextGeneration();
+}
+
+void ConfigManager::addCommonWord(const std::string& word) {
+    if (insertCommonWord(word)) rebuildWordMatcher();
+}
+
+void ConfigManager::removeCommonWord(const std::string& word) {
+    detachImageWords();
+    common_words_.erase(
+        std::remove(common_words_.begin(), common_words_.end(), word),
+        common_words_.end()
+    );
+    rebuildWordMatcher();
+}
+
+size_t ConfigManager::importWordList(const std::string& filename) {
+    detachImageWords();
+    size_t before = common_words_.size();
+    try {
+        WordList::import(filename, common_words_, ThreadPool::shared());
+    }
+    catch (...) {
+        if (common_words_.size() != before) rebuildWordMatcher();
+        throw;
+    }
+    if (common_words_.size() != before) rebuildWordMatcher();
+    return common_words_.size() - before;
+}
+
+bool ConfigManager::insertCommonWord(const std::string& word) {
+    detachImageWords();
+    if (std::find(common_words_.begin(), common_words_.end(), word) != common_words_.end()) return false;
+    common_words_.push_back(word);
+    return true;
+}
+
+void ConfigManager::detachImageWords() {
+    if (!image_words_) return;
+    common_words_ = image_words_->list();
+    image_words_.reset();
+}
+
+void ConfigManager::rebuildWordMatcher() {
+    word_matcher_ = std::make_shared<const WordMatcher>(common_words_);
+    generation_ = nextGeneration();
+}
+
+bool ConfigManager::loadFromFile(const std::string& filename) {
+    if (isCompiledImage(filename)) return loadImage(filename);
+
+    bool words_changed = false;
+    try {
+        std::ifstream file(filename);
+        if (!file.is_open()) return false;
+
+        // Large word lists would make a linear duplicate check per word quadratic.
+        std::unordered_set<std::string> known_words;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            
+            std::istringstream iss(line);
+            std::string key;
+            if (std::getline(iss, key, '=')) {
+                std::string value;
+                if (std::getline(iss, value)) {
+                    if (key == "min_length") setMinLength(std::stoi(value));
+                    else if (key == "max_length") setMaxLength(std::stoi(value));
+                    else if (key == "strict_mode") setStrictMode(value == "true" || value == "1");
+                    else if (key == "min_entropy_bits") setMinEntropyBits(std::stoi(value));
+                    else if (key == "common_word") {
+                        if (known_words.empty()) {
+                            detachImageWords();
+                            known_words.insert(common_words_.begin(), common_words_.end());
+                        }
+                        if (known_words.insert(value).second) {
+                            common_words_.push_back(value);
+                            words_changed = true;
+                        }
+                    }
+                    else if (key == "wordlist") {
+                        detachImageWords();
+                        words_changed = true;
+                        WordList::import(value, common_words_, ThreadPool::shared());
+                        known_words.clear();
+                    }
+                    else if (key == "breach_corpus") setBreachCorpusPath(value);
+                    else if (key == "breach_filter") setBreachFilterPath(value);
+                    else if (key == "markov_model") setMarkovModelPath(value);
+                    else if (key == "scoring") {
+                        if (value == "guesses") setScoringMode(ScoringMode::GUESSES);
+                        else if (value == "checklist") setScoringMode(ScoringMode::CHECKLIST);
+                        else throw std::invalid_argument("Unknown scoring mode: " + value);
+                    }
+                    else if (key == "encoding") {
+                        if (value == "utf8") setTextEncoding(TextEncoding::UTF8);
+                        else if (value == "bytes") setTextEncoding(TextEncoding::BYTES);
+                        else throw std::invalid_argument("Unknown text encoding: " + value);
+                    }
+                }
+            }
+        }
+        if (words_changed) rebuildWordMatcher();
+        return true;
+    }
+    catch (const std::exception& e) {
+        if (words_changed) rebuildWordMatcher();
+        return false;
+    }
+}
+
+bool ConfigManager::saveToFile(const std::string& filename) const {
+    try {
+        std::ofstream file(filename);
+        if (!file.is_open()) return false;
+
+        file << "min_length=" << min_length_ << "\n";
+        file << "max_length=" << max_length_ << "\n";
+        file << "strict_mode=" << (strict_mode_ ? "true" : "false") << "\n";
+        file << "min_entropy_bits=" << min_entropy_bits_ << "\n";
+        if (!breach_corpus_path_.empty()) file << "breach_corpus=" << breach_corpus_path_ << "\n";
+        if (!breach_filter_path_.empty()) file << "breach_filter=" << breach_filter_path_ << "\n";
+        if (!markov_model_path_.empty()) file << "markov_model=" << markov_model_path_ << "\n";
+        if (scoring_mode_ == ScoringMode::GUESSES) file << "scoring=guesses\n";
+        if (text_encoding_ == TextEncoding::UTF8) file << "encoding=utf8\n";
+
+        for (const auto& word : getCommonWords()) {
+            file << "common_word=" << word << "\n";
+        }
+        
+        return true;
+    }
+    catch (const std::exception& e) {
+        return false;
+    }
+}
+
+bool ConfigManager::isCompiledImage(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    char magic[sizeof(IMAGE_MAGIC)];
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC)) == 0;
+}
+
+bool ConfigManager::compileToFile(const std::string& filename) const {
+    std::string temp_file = filename + ".tmp";
+    try {
+        const auto& words = getCommonWords();
+        std::vector<uint32_t> word_offsets;
+        word_offsets.reserve(words.size() + 1);
+        word_offsets.push_back(0);
+        uint64_t word_bytes = 0;
+        for (const auto& word : words) {
+            word_bytes += word.size();
+            if (word_bytes > UINT32_MAX) throw std::length_error("Word list is too large for a configuration image");
+            word_offsets.push_back(static_cast<uint32_t>(word_bytes));
+        }
+
+        std::ofstream out(temp_file, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+
+        ImageSection sections[SECTION_COUNT] = {};
+        uint64_t offset = IMAGE_PREFIX_BYTES;
+        out.write(std::string(IMAGE_PREFIX_BYTES, '\0').data(), IMAGE_PREFIX_BYTES);
+        auto begin_section = [&](ImageSectionId id) {
+            uint64_t aligned = (offset + IMAGE_ALIGNMENT - 1) & ~uint64_t(IMAGE_ALIGNMENT - 1);
+            out.write(std::string(aligned - offset, '\0').data(), static_cast<std::streamsize>(aligned - offset));
+            sections[id].offset = aligned;
+        };
+        auto end_section = [&](ImageSectionId id) {
+            offset = static_cast<uint64_t>(out.tellp());
+            sections[id].size = offset - sections[id].offset;
+        };
+        auto write_section = [&](ImageSectionId id, const void* data, size_t size) {
+            begin_section(id);
+            out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            end_section(id);
+        };
+
+        write_section(SECTION_BREACH_CORPUS_PATH, breach_corpus_path_.data(), breach_corpus_path_.size());
+        write_section(SECTION_BREACH_FILTER_PATH, breach_filter_path_.data(), breach_filter_path_.size());
+        write_section(SECTION_MARKOV_MODEL_PATH, markov_model_path_.data(), markov_model_path_.size());
+        write_section(SECTION_WORD_OFFSETS, word_offsets.data(), word_offsets.size() * sizeof(uint32_t));
+        begin_section(SECTION_WORD_CHARS);
+        for (const auto& word : words) out.write(word.data(), static_cast<std::streamsize>(word.size()));
+        end_section(SECTION_WORD_CHARS);
+        begin_section(SECTION_WORD_MATCHER);
+        word_matcher_->writeImage(out);
+        end_section(SECTION_WORD_MATCHER);
+
+        ImageHeader header = {};
+        std::memcpy(header.magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC));
+        header.version = IMAGE_VERSION;
+        header.section_count = SECTION_COUNT;
+        header.file_size = offset;
+        ImageSettings settings = {};
+        settings.min_length = min_length_;
+        settings.max_length = max_length_;
+        settings.min_entropy_bits = min_entropy_bits_;
+        settings.strict_mode = strict_mode_ ? 1 : 0;
+        settings.scoring_mode = static_cast<uint32_t>(scoring_mode_);
+        settings.text_encoding = static_cast<uint32_t>(text_encoding_);
+        out.seekp(sizeof(ImageHeader));
+        out.write(reinterpret_cast<const char*>(&settings), sizeof(settings));
+        out.write(reinterpret_cast<const char*>(sections), sizeof(sections));
+        out.close();
+        if (!out) throw std::runtime_error("Failed to write configuration image: " + temp_file);
+
+        {
+            MappedFile written(temp_file, MappedFileAccess::SEQUENTIAL);
+            if (written.size() != header.file_size) throw std::runtime_error("Short write to configuration image: " + temp_file);
+            header.checksum = Hash::xxh64(written.data() + sizeof(ImageHeader), written.size() - sizeof(ImageHeader));
+        }
+        std::fstream patch(temp_file, std::ios::binary | std::ios::in | std::ios::out);
+        patch.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        patch.close();
+        if (!patch) throw std::runtime_error("Failed to write configuration image: " + temp_file);
+
+        if (std::rename(temp_file.c_str(), filename.c_str()) != 0) {
+            std::remove(filename.c_str());
+            if (std::rename(temp_file.c_str(), filename.c_str()) != 0) throw std::runtime_error("Failed to replace " + filename);
+        }
+        return true;
+    }
+    catch (const std::exception& e) {
+        std::remove(temp_file.c_str());
+        return false;
+    }
+}
+
+bool ConfigManager::loadImage(const std::string& filename) {
+    try {
+        auto file = std::make_shared<const MappedFile>(filename, MappedFileAccess::NORMAL);
+        const unsigned char* data = file->data();
+        if (file->size() < IMAGE_PREFIX_BYTES) return false;
+
+        ImageHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC)) != 0 || header.version != IMAGE_VERSION ||
+            header.section_count != SECTION_COUNT || header.file_size != file->size() ||
+            header.checksum != Hash::xxh64(data + sizeof(ImageHeader), file->size() - sizeof(ImageHeader))) {
+            return false;
+        }
+
+        ImageSettings settings;
+        ImageSection sections[SECTION_COUNT];
+        std::memcpy(&settings, data + sizeof(ImageHeader), sizeof(settings));
+        std::memcpy(sections, data + sizeof(ImageHeader) + sizeof(settings), sizeof(sections));
+        for (const auto& section : sections) {
+            if (section.offset % IMAGE_ALIGNMENT != 0 || section.offset > file->size() ||
+                section.size > file->size() - section.offset) {
+                return false;
+            }
+        }
+        if (settings.min_length > settings.max_length || settings.min_entropy_bits < 0 ||
+            settings.scoring_mode > static_cast<uint32_t>(ScoringMode::GUESSES) ||
+            settings.text_encoding > static_cast<uint32_t>(TextEncoding::UTF8)) {
+            return false;
+        }
+
+        auto section_string = [&](ImageSectionId id) {
+            return std::string(reinterpret_cast<const char*>(data + sections[id].offset), sections[id].size);
+        };
+        std::string corpus_path = section_string(SECTION_BREACH_CORPUS_PATH);
+        std::string filter_path = section_string(SECTION_BREACH_FILTER_PATH);
+        std::shared_ptr<const BreachCorpus> corpus;
+        if (!corpus_path.empty()) corpus = std::make_shared<const BreachCorpus>(corpus_path);
+        std::shared_ptr<const BreachFilter> filter;
+        if (!filter_path.empty()) filter = std::make_shared<const BreachFilter>(filter_path);
+        std::string model_path = section_string(SECTION_MARKOV_MODEL_PATH);
+        std::shared_ptr<const MarkovModel> model;
+        if (!model_path.empty()) model = std::make_shared<const MarkovModel>(model_path);
+
+        const ImageSection& offsets = sections[SECTION_WORD_OFFSETS];
+        const ImageSection& chars = sections[SECTION_WORD_CHARS];
+        if (offsets.size < sizeof(uint32_t) || offsets.size % sizeof(uint32_t) != 0) return false;
+        auto words = std::make_shared<ImageWords>();
+        words->file = file;
+        words->offsets = reinterpret_cast<const uint32_t*>(data + offsets.offset);
+        words->chars = reinterpret_cast<const char*>(data + chars.offset);
+        words->count = offsets.size / sizeof(uint32_t) - 1;
+        // list() reads each word between adjacent offsets, so they must stay inside the characters.
+        if (words->offsets[0] != 0 || words->offsets[words->count] != chars.size) return false;
+        for (size_t i = 0; i < words->count; ++i) {
+            if (words->offsets[i] > words->offsets[i + 1]) return false;
+        }
+
+        const ImageSection& matcher = sections[SECTION_WORD_MATCHER];
+        auto word_matcher = std::make_shared<const WordMatcher>(file, data + matcher.offset, matcher.size);
+
+        min_length_ = static_cast<size_t>(settings.min_length);
+        max_length_ = static_cast<size_t>(settings.max_length);
+        min_entropy_bits_ = settings.min_entropy_bits;
+        strict_mode_ = settings.strict_mode != 0;
+        scoring_mode_ = static_cast<ScoringMode>(settings.scoring_mode);
+        text_encoding_ = static_cast<TextEncoding>(settings.text_encoding);
+        breach_corpus_path_ = std::move(corpus_path);
+        breach_corpus_ = std::move(corpus);
+        breach_filter_path_ = std::move(filter_path);
+        breach_filter_ = std::move(filter);
+        markov_model_path_ = std::move(model_path);
+        markov_model_ = std::move(model);
+        common_words_.clear();
+        common_words_.shrink_to_fit();
+        image_words_ = std::move(words);
+        word_matcher_ = std::move(word_matcher);
+        generation_ = nextGeneration();
+        return true;
+    }
+    catch (const std::exception& e) {
+        return false;
+    }
+}
+
+void ConfigManager::resetToDefaults() {
+    initializeDefaults();
 }
\ No newline at end of file
@@ -1,39 +1,98 @@
-#ifndef CONFIG_MANAGER_HPP
-#define CONFIG_MANAGER_HPP
-#include <vector>
-#include <string>
-#include <map>
-
-class ConfigManager {
-public:
-    ConfigManager();
-    explicit ConfigManager(const std::string& config_file);
-    
-    size_t getMinLength() const;
-    size_t getMaxLength() const;
-    const std::vector<std::string>& getCommonWords() const;
-    bool isStrictMode() const;
-    int getMinEntropyBits() const;
-    
-    void setMinLength(size_t length);
-    void setMaxLength(size_t length);
-    void setStrictMode(bool strict);
-    void setMinEntropyBits(int bits);
-    void addCommonWord(const std::string& word);
-    void removeCommonWord(const std::string& word);
-    
-    bool loadFromFile(const std::string& filename);
-    bool saveToFile(const std::string& filename) const;
-    void resetToDefaults();
-
-private:
-    size_t min_length_;
-    size_t max_length_;
-    bool strict_mode_;
-    int min_entropy_bits_;
-    std::vector<std::string> common_words_;
-    std::map<std::string, std::string> custom_rules_;
-    void initializeDefaults();
-};
-
+#ifndef CONFIG_MANAGER_HPP
+#define CONFIG_MANAGER_HPP
+#include <vector>
+#include <string>
+#include <map>
+#include <memory>
+#include <cstdint>
+#include "BreachCorpus.hpp"
+#include "BreachFilter.hpp"
+#include "CharClass.hpp"
+#include "MarkovModel.hpp"
+#include "WordMatcher.hpp"
+
+// How the checker turns features into a strength: the weighted checklist of PasswordPolicy.hpp, or
+// the number of guesses GuessEstimator expects an attacker to need.
+enum class ScoringMode {
+    CHECKLIST,
+    GUESSES
+};
+
+class ConfigManager {
+public:
+    ConfigManager();
+    explicit ConfigManager(const std::string& config_file);
+    
+    size_t getMinLength() const;
+    size_t getMaxLength() const;
+    const std::vector<std::string>& getCommonWords() const;
+    const WordMatcher& getWordMatcher() const;
+    bool isStrictMode() const;
+    int getMinEntropyBits() const;
+    const std::string& getBreachCorpusPath() const;
+    const BreachCorpus* getBreachCorpus() const;
+    const std::string& getBreachFilterPath() const;
+    const BreachFilter* getBreachFilter() const;
+    const std::string& getMarkovModelPath() const;
+    const MarkovModel* getMarkovModel() const;
+    ScoringMode getScoringMode() const;
+    TextEncoding getTextEncoding() const;
+    // Changes whenever any setting or word changes, so derived data can tell when it is stale.
+    // Generations are unique across instances; copies keep the generation of their source.
+    uint64_t getGeneration() const;
+    
+    void setMinLength(size_t length);
+    void setMaxLength(size_t length);
+    void setStrictMode(bool strict);
+    void setMinEntropyBits(int bits);
+    void setBreachCorpusPath(const std::string& path);
+    void setBreachFilterPath(const std::string& path);
+    void setMarkovModelPath(const std::string& path);
+    void setScoringMode(ScoringMode mode);
+    void setTextEncoding(TextEncoding encoding);
+    void addCommonWord(const std::string& word);
+    void removeCommonWord(const std::string& word);
+    // Adds every word of a word list file (see WordList.hpp), trimmed and lower-cased, skipping
+    // words already in the list. Returns how many were added; throws if the file cannot be read.
+    size_t importWordList(const std::string& filename);
+    
+    // Reads either a text key=value file, whose settings and words are merged into the current
+    // ones, or a compiled image, which replaces the whole configuration.
+    bool loadFromFile(const std::string& filename);
+    bool saveToFile(const std::string& filename) const;
+    // Writes the whole configuration, word matcher included, as a checksummed binary image that
+    // loadFromFile maps and uses in place. The file is replaced by rename, so processes that have
+    // the old image mapped keep a consistent copy.
+    bool compileToFile(const std::string& filename) const;
+    static bool isCompiledImage(const std::string& filename);
+    void resetToDefaults();
+
+private:
+    size_t min_length_;
+    size_t max_length_;
+    bool strict_mode_;
+    int min_entropy_bits_;
+    struct ImageWords;
+
+    std::vector<std::string> common_words_;
+    // Set while the words still live in a loaded image; the list is only built if someone asks.
+    std::shared_ptr<const ImageWords> image_words_;
+    std::shared_ptr<const WordMatcher> word_matcher_;
+    std::string breach_corpus_path_;
+    std::shared_ptr<const BreachCorpus> breach_corpus_;
+    std::string breach_filter_path_;
+    std::shared_ptr<const BreachFilter> breach_filter_;
+    std::string markov_model_path_;
+    std::shared_ptr<const MarkovModel> markov_model_;
+    ScoringMode scoring_mode_;
+    TextEncoding text_encoding_;
+    std::map<std::string, std::string> custom_rules_;
+    uint64_t generation_ = 0;
+    void initializeDefaults();
+    bool insertCommonWord(const std::string& word);
+    void detachImageWords();
+    void rebuildWordMatcher();
+    bool loadImage(const std::string& filename);
+};
+
 #endif
\ No newline at end of file
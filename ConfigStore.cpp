@@ -0,0 +1,226 @@
+#include "ConfigStore.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <system_error>
+#include <vector>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    // Editors often write a file in several steps; wait this long after the last event.
+    constexpr auto SETTLE_DELAY = std::chrono::milliseconds(100);
+    constexpr auto POLL_INTERVAL = std::chrono::milliseconds(500);
+
+    std::atomic<uint64_t> next_store_id(1);
+    // Moves on whenever any store publishes or is destroyed, so a thread whose cache was checked
+    // at the current value knows every entry in it is still current.
+    std::atomic<uint64_t> store_epoch(1);
+
+    struct CachedSnapshot {
+        uint64_t store_id;
+        std::weak_ptr<const std::atomic<uint64_t>> store_version;
+        uint64_t version;
+        std::shared_ptr<const ConfigManager> config;
+    };
+
+    struct SnapshotCache {
+        uint64_t epoch = 0;
+        // One entry per store this thread has read from, usually just one.
+        std::vector<CachedSnapshot> entries;
+    };
+
+    thread_local SnapshotCache snapshot_cache;
+
+    void dropStaleSnapshots(SnapshotCache& cache) {
+        auto stale = [](const CachedSnapshot& cached) {
+            auto version = cached.store_version.lock();
+            return !version || version->load(std::memory_order_acquire) != cached.version;
+        };
+        cache.entries.erase(std::remove_if(cache.entries.begin(), cache.entries.end(), stale), cache.entries.end());
+    }
+
+    std::filesystem::file_time_type modificationTime(const std::string& path) {
+        std::error_code error;
+        auto time = std::filesystem::last_write_time(path, error);
+        return error ? std::filesystem::file_time_type::min() : time;
+    }
+}
+
+ConfigStore::ConfigStore() : ConfigStore(ConfigManager()) {
+}
+
+ConfigStore::ConfigStore(const ConfigManager& initial)
+    : id_(next_store_id.fetch_add(1, std::memory_order_relaxed)),
+    current_(std::make_shared<const ConfigManager>(initial)),
+    version_(std::make_shared<std::atomic<uint64_t>>(1)),
+    watch_stop_(false),
+    watch_wake_fd_(-1) {
+}
+
+ConfigStore::~ConfigStore() {
+    stopWatching();
+    store_epoch.fetch_add(1, std::memory_order_release);
+}
+
+const ConfigManager& ConfigStore::current() const {
+    SnapshotCache& cache = snapshot_cache;
+    uint64_t epoch = store_epoch.load(std::memory_order_acquire);
+    if (cache.epoch != epoch) {
+        dropStaleSnapshots(cache);
+        cache.epoch = epoch;
+    }
+    for (const CachedSnapshot& cached : cache.entries) {
+        if (cached.store_id == id_) return *cached.config;
+    }
+    // The version is read before the pointer; if a publish lands in between, the entry looks
+    // stale at the next epoch and is simply fetched again.
+    uint64_t version = version_->load(std::memory_order_acquire);
+    cache.entries.push_back({ id_, version_, version, std::atomic_load(&current_) });
+    return *cache.entries.back().config;
+}
+
+void ConfigStore::releaseThreadSnapshots() {
+    snapshot_cache.entries.clear();
+}
+
+std::shared_ptr<const ConfigManager> ConfigStore::snapshot() const {
+    return std::atomic_load(&current_);
+}
+
+uint64_t ConfigStore::getVersion() const {
+    return version_->load(std::memory_order_acquire);
+}
+
+void ConfigStore::publish(const ConfigManager& config) {
+    auto next = std::make_shared<const ConfigManager>(config);
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    publishLocked(std::move(next));
+}
+
+void ConfigStore::update(const std::function<void(ConfigManager&)>& change) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto next = std::make_shared<ConfigManager>(*std::atomic_load(&current_));
+    change(*next);
+    publishLocked(std::move(next));
+}
+
+void ConfigStore::publishLocked(std::shared_ptr<const ConfigManager> config) {
+    // The pointer goes first: a reader that sees the new version is sure to load the new snapshot.
+    std::atomic_store(&current_, std::move(config));
+    version_->fetch_add(1, std::memory_order_release);
+    store_epoch.fetch_add(1, std::memory_order_release);
+}
+
+bool ConfigStore::reloadFromFile(const std::string& path) {
+    // Loading may parse large word lists or map breach files; do it before taking the write lock.
+    std::shared_ptr<const ConfigManager> next;
+    try {
+        next = std::make_shared<const ConfigManager>(path);
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    publishLocked(std::move(next));
+    return true;
+}
+
+void ConfigStore::watchFile(const std::string& path, ReloadListener listener) {
+    stopWatching();
+    std::lock_guard<std::mutex> lock(watch_mutex_);
+    watch_stop_ = false;
+    listener_ = std::move(listener);
+#ifdef __linux__
+    watch_wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#endif
+    watcher_ = std::thread([this, path] { watchLoop(path); });
+}
+
+void ConfigStore::stopWatching() {
+    {
+        std::lock_guard<std::mutex> lock(watch_mutex_);
+        watch_stop_ = true;
+    }
+    watch_wake_.notify_all();
+#ifdef __linux__
+    if (watch_wake_fd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t ignored = write(watch_wake_fd_, &one, sizeof(one));
+        (void)ignored;
+    }
+#endif
+    if (watcher_.joinable()) watcher_.join();
+#ifdef __linux__
+    if (watch_wake_fd_ >= 0) close(watch_wake_fd_);
+    watch_wake_fd_ = -1;
+#endif
+}
+
+void ConfigStore::reloadAndNotify(const std::string& path) {
+    bool loaded = reloadFromFile(path);
+    if (listener_) {
+        listener_(loaded, loaded ? "Reloaded configuration from " + path
+                                 : "Failed to reload configuration from " + path + "; keeping the previous one");
+    }
+}
+
+void ConfigStore::watchLoop(const std::string& path) {
+    auto stopping = [this] {
+        std::lock_guard<std::mutex> lock(watch_mutex_);
+        return watch_stop_;
+    };
+
+#ifdef __linux__
+    // Watch the directory rather than the file, so that editors which replace the file by renaming
+    // a new one over it are noticed too.
+    std::filesystem::path file(path);
+    std::string directory = file.has_parent_path() ? file.parent_path().string() : ".";
+    std::string name = file.filename().string();
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd >= 0 && watch_wake_fd_ >= 0 &&
+        inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) >= 0) {
+        alignas(inotify_event) char buffer[4096];
+        bool pending = false;
+        while (!stopping()) {
+            pollfd descriptors[2] = { { fd, POLLIN, 0 }, { watch_wake_fd_, POLLIN, 0 } };
+            int timeout = pending ? static_cast<int>(SETTLE_DELAY.count()) : -1;
+            int ready = poll(descriptors, 2, timeout);
+            if (ready > 0 && (descriptors[1].revents & POLLIN)) break;
+            if (ready > 0) {
+                ssize_t size;
+                while ((size = read(fd, buffer, sizeof(buffer))) > 0) {
+                    for (char* p = buffer; p < buffer + size;) {
+                        auto* event = reinterpret_cast<inotify_event*>(p);
+                        if (event->len > 0 && name == event->name) pending = true;
+                        p += sizeof(inotify_event) + event->len;
+                    }
+                }
+            } else if (ready == 0 && pending) {
+                pending = false;
+                reloadAndNotify(path);
+            }
+        }
+        close(fd);
+        return;
+    }
+    if (fd >= 0) close(fd);
+#endif
+
+    auto last = modificationTime(path);
+    std::unique_lock<std::mutex> lock(watch_mutex_);
+    while (!watch_wake_.wait_for(lock, POLL_INTERVAL, [this] { return watch_stop_; })) {
+        auto now = modificationTime(path);
+        if (now == last) continue;
+        last = now;
+        lock.unlock();
+        std::this_thread::sleep_for(SETTLE_DELAY);
+        reloadAndNotify(path);
+        lock.lock();
+    }
+}
\ No newline at end of file
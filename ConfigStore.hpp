@@ -0,0 +1,75 @@
+#ifndef CONFIG_STORE_HPP
+#define CONFIG_STORE_HPP
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "ConfigManager.hpp"
+
+// Publishes immutable ConfigManager snapshots, including their compiled word matcher and breach
+// sources, to concurrent readers. Writers build a complete new snapshot and swap it in; readers
+// keep a per-thread copy of the snapshot pointer and only compare a counter on the hot path, so
+// they never lock or touch a shared reference count while the configuration is stable. A thread
+// drops its copies of replaced snapshots, and of stores that are gone, the next time it reads any
+// store, so an old snapshot with its mapped breach corpus is not kept alive by idle readers.
+//
+// watchFile() reloads the snapshot in the background whenever the file changes (inotify on Linux,
+// modification-time polling elsewhere). A file that fails to load leaves the current snapshot in
+// place.
+class ConfigStore {
+public:
+    // Called from the watcher thread after every reload attempt.
+    using ReloadListener = std::function<void(bool loaded, const std::string& message)>;
+
+    ConfigStore();
+    explicit ConfigStore(const ConfigManager& initial);
+    ~ConfigStore();
+
+    ConfigStore(const ConfigStore&) = delete;
+    ConfigStore& operator=(const ConfigStore&) = delete;
+
+    // The current snapshot, without locking. The reference stays valid until this thread calls
+    // current() on any store again or releases its snapshots, so take it once per unit of work.
+    const ConfigManager& current() const;
+    // The current snapshot, owned by the caller for as long as it likes.
+    std::shared_ptr<const ConfigManager> snapshot() const;
+    uint64_t getVersion() const;
+
+    void publish(const ConfigManager& config);
+    // Applies change to a copy of the current snapshot and publishes the copy. Concurrent updates
+    // are serialized, so none is lost.
+    void update(const std::function<void(ConfigManager&)>& change);
+
+    // Drops the snapshots this thread has cached. Threads that go idle for a long time, such as
+    // pool workers after a batch check, call this so they do not hold on to any snapshot meanwhile.
+    static void releaseThreadSnapshots();
+
+    void watchFile(const std::string& path, ReloadListener listener = ReloadListener());
+    void stopWatching();
+    bool reloadFromFile(const std::string& path);
+
+private:
+    const uint64_t id_;
+    std::shared_ptr<const ConfigManager> current_;
+    // Shared with the thread caches, which hold it weakly to tell when this store is gone.
+    const std::shared_ptr<std::atomic<uint64_t>> version_;
+    std::mutex write_mutex_;
+
+    std::thread watcher_;
+    std::mutex watch_mutex_;
+    std::condition_variable watch_wake_;
+    bool watch_stop_;
+    // Wakes the inotify watcher when stopWatching is called.
+    int watch_wake_fd_;
+    ReloadListener listener_;
+
+    void publishLocked(std::shared_ptr<const ConfigManager> config);
+    void watchLoop(const std::string& path);
+    void reloadAndNotify(const std::string& path);
+};
+
+#endif
\ No newline at end of file
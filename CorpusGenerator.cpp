@@ -0,0 +1,217 @@
+#include "CorpusGenerator.hpp"
+#include <stdexcept>
+#include <unordered_set>
+
+namespace {
+    const char* const COMMON_WORDS[] = {
+        "password", "qwerty", "dragon", "monkey", "letmein", "football", "baseball", "shadow",
+        "master", "sunshine", "princess", "welcome", "admin", "login", "starwars", "freedom",
+        "whatever", "trustno", "superman", "batman", "iloveyou", "charlie", "hello", "secret",
+        "summer", "winter", "spring", "autumn", "flower", "orange", "banana", "cookie",
+        "soccer", "hockey", "killer", "pepper", "ginger", "cheese", "purple", "silver",
+        "golden", "diamond", "tigger", "hunter", "ranger", "buster", "thunder", "matrix",
+        "mustang", "jordan", "harley", "maverick", "phoenix", "falcon", "angel", "lovely",
+        "family", "forever", "friend", "computer", "internet", "samsung", "google", "access",
+        "change", "default", "guest", "office", "school", "money", "happy", "lucky"
+    };
+
+    const char* const NAMES[] = {
+        "michael", "jennifer", "jessica", "ashley", "daniel", "andrew", "joshua", "matthew",
+        "robert", "thomas", "nicole", "amanda", "sarah", "david", "james", "maria",
+        "anna", "alex", "chris", "kevin", "laura", "emily", "olivia", "sophie"
+    };
+
+    const char* const KEYBOARD_WALKS[] = {
+        "qwerty", "qwertyuiop", "asdfgh", "asdfghjkl", "zxcvbn", "zxcvbnm", "1qaz2wsx",
+        "qazwsx", "1q2w3e4r", "1q2w3e", "q1w2e3r4", "!qaz@wsx", "poiuytrewq", "qweasdzxc",
+        "123qwe", "qwe123", "asd123", "zaq12wsx"
+    };
+
+    const char* const ONSETS[] = {
+        "b", "c", "d", "f", "g", "h", "j", "k", "l", "m", "n", "p", "r", "s", "t", "v", "w", "z",
+        "br", "cr", "dr", "fl", "gr", "pl", "st", "tr", "ch", "sh", "th"
+    };
+    const char* const VOWELS[] = { "a", "e", "i", "o", "u", "ai", "ea", "ee", "oo", "ou" };
+    const char* const CODAS[] = { "", "", "", "n", "r", "s", "t", "l", "m", "nd", "st", "rk" };
+
+    const char SYMBOLS[] = "!@#$%&*?._-";
+    const char PRINTABLE[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789!@#$%^&*()_+-=[]{}|;:,.<>?";
+
+    template <typename T, size_t N>
+    constexpr size_t countOf(const T (&)[N]) {
+        return N;
+    }
+
+    char leet(char c) {
+        switch (c) {
+            case 'a': return '@';
+            case 'e': return '3';
+            case 'i': return '1';
+            case 'o': return '0';
+            case 's': return '$';
+            default: return c;
+        }
+    }
+}
+
+CorpusGenerator::CorpusGenerator(uint64_t seed) : state_(seed) {
+}
+
+// splitmix64 rather than <random>: the standard distributions are not specified bit-for-bit,
+// so the same seed would give different corpora on different standard libraries.
+uint64_t CorpusGenerator::nextRandom() {
+    uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+size_t CorpusGenerator::uniform(size_t bound) {
+    uint64_t limit = UINT64_MAX - UINT64_MAX % bound;
+    uint64_t value;
+    do {
+        value = nextRandom();
+    } while (value >= limit);
+    return static_cast<size_t>(value % bound);
+}
+
+bool CorpusGenerator::chance(unsigned percent) {
+    return uniform(100) < percent;
+}
+
+std::string CorpusGenerator::commonWord() {
+    return COMMON_WORDS[uniform(countOf(COMMON_WORDS))];
+}
+
+std::string CorpusGenerator::syllableWord() {
+    std::string word;
+    size_t syllables = 1 + uniform(3);
+    for (size_t i = 0; i < syllables; ++i) {
+        word += ONSETS[uniform(countOf(ONSETS))];
+        word += VOWELS[uniform(countOf(VOWELS))];
+    }
+    word += CODAS[uniform(countOf(CODAS))];
+    return word;
+}
+
+std::string CorpusGenerator::digits(size_t count) {
+    std::string result;
+    for (size_t i = 0; i < count; ++i) result += static_cast<char>('0' + uniform(10));
+    return result;
+}
+
+std::string CorpusGenerator::year() {
+    return std::to_string(1950 + uniform(76));
+}
+
+void CorpusGenerator::decorate(std::string& password) {
+    if (chance(30) && password[0] >= 'a' && password[0] <= 'z') password[0] = static_cast<char>(password[0] - 'a' + 'A');
+    if (chance(8)) {
+        for (char& c : password) {
+            if (chance(50)) c = leet(c);
+        }
+    }
+}
+
+std::string CorpusGenerator::wordWithSuffix() {
+    std::string password = chance(70) ? commonWord() : syllableWord();
+    decorate(password);
+    unsigned kind = static_cast<unsigned>(uniform(100));
+    if (kind < 35) password += digits(1 + uniform(3));
+    else if (kind < 45) password += "123";
+    else if (kind < 55) password += year().substr(uniform(2) * 2);
+    if (chance(15)) password += SYMBOLS[uniform(sizeof(SYMBOLS) - 1)];
+    return password;
+}
+
+std::string CorpusGenerator::nameWithYear() {
+    std::string password = NAMES[uniform(countOf(NAMES))];
+    decorate(password);
+    password += chance(60) ? year() : digits(2);
+    return password;
+}
+
+std::string CorpusGenerator::keyboardWalk() {
+    std::string password = KEYBOARD_WALKS[uniform(countOf(KEYBOARD_WALKS))];
+    if (chance(25)) password += digits(1 + uniform(3));
+    return password;
+}
+
+std::string CorpusGenerator::numericPin() {
+    static const char* const SEQUENCES[] = { "123456", "12345678", "123456789", "111111", "000000", "654321" };
+    if (chance(40)) return SEQUENCES[uniform(countOf(SEQUENCES))];
+    return digits(4 + uniform(7));
+}
+
+std::string CorpusGenerator::passphrase() {
+    static const char SEPARATORS[] = { '-', '_', '.', ' ' };
+    std::string password;
+    size_t words = 3 + uniform(4);
+    char separator = chance(40) ? '\0' : SEPARATORS[uniform(sizeof(SEPARATORS))];
+    for (size_t i = 0; i < words; ++i) {
+        if (i > 0 && separator) password += separator;
+        password += chance(50) ? commonWord() : syllableWord();
+    }
+    if (chance(30)) password += digits(1 + uniform(2));
+    return password;
+}
+
+std::string CorpusGenerator::randomString() {
+    std::string password;
+    size_t length = 8 + uniform(17);
+    for (size_t i = 0; i < length; ++i) password += PRINTABLE[uniform(sizeof(PRINTABLE) - 1)];
+    return password;
+}
+
+std::string CorpusGenerator::next() {
+    unsigned kind = static_cast<unsigned>(uniform(100));
+    if (kind < 40) return wordWithSuffix();
+    if (kind < 55) return nameWithYear();
+    if (kind < 65) return keyboardWalk();
+    if (kind < 80) return numericPin();
+    if (kind < 88) return passphrase();
+    return randomString();
+}
+
+std::string CorpusGenerator::next(size_t min_length, size_t max_length) {
+    if (min_length == 0 || min_length > max_length) throw std::invalid_argument("Invalid password length range");
+
+    for (int attempt = 0; attempt < 1000; ++attempt) {
+        std::string password = next();
+        if (password.size() >= min_length && password.size() <= max_length) return password;
+    }
+    // Ranges the mix almost never produces (very long passwords) are filled with passphrases.
+    std::string password = passphrase();
+    while (password.size() < min_length) password += passphrase();
+    password.resize(min_length + uniform(max_length - min_length + 1), '0');
+    return password;
+}
+
+std::vector<std::string> CorpusGenerator::generate(size_t count) {
+    std::vector<std::string> passwords;
+    passwords.reserve(count);
+    for (size_t i = 0; i < count; ++i) passwords.push_back(next());
+    return passwords;
+}
+
+std::vector<std::string> CorpusGenerator::generate(size_t count, size_t min_length, size_t max_length) {
+    std::vector<std::string> passwords;
+    passwords.reserve(count);
+    for (size_t i = 0; i < count; ++i) passwords.push_back(next(min_length, max_length));
+    return passwords;
+}
+
+std::vector<std::string> CorpusGenerator::dictionary(size_t count) {
+    std::vector<std::string> words;
+    std::unordered_set<std::string> seen;
+    words.reserve(count);
+    for (size_t i = 0; i < countOf(COMMON_WORDS) && words.size() < count; ++i) {
+        if (seen.insert(COMMON_WORDS[i]).second) words.push_back(COMMON_WORDS[i]);
+    }
+    while (words.size() < count) {
+        std::string word = syllableWord();
+        if (word.size() >= 4 && seen.insert(word).second) words.push_back(word);
+    }
+    return words;
+}
\ No newline at end of file
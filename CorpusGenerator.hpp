@@ -0,0 +1,46 @@
+#ifndef CORPUS_GENERATOR_HPP
+#define CORPUS_GENERATOR_HPP
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Deterministic source of synthetic passwords shaped like leaked password lists: dictionary words
+// with digit and symbol suffixes, names with years, keyboard walks, PINs, passphrases and a tail
+// of random strings. The same seed gives the same output on every platform and standard library,
+// so benchmark inputs stay comparable between commits.
+class CorpusGenerator {
+public:
+    explicit CorpusGenerator(uint64_t seed = 1);
+
+    std::string next();
+    // Draws from the same mix but only keeps passwords whose length is in [min_length, max_length].
+    std::string next(size_t min_length, size_t max_length);
+    std::vector<std::string> generate(size_t count);
+    std::vector<std::string> generate(size_t count, size_t min_length, size_t max_length);
+
+    // Distinct lowercase words for dictionary benchmarks: the built-in common words first, then
+    // pronounceable made-up words.
+    std::vector<std::string> dictionary(size_t count);
+
+private:
+    uint64_t state_;
+
+    uint64_t nextRandom();
+    size_t uniform(size_t bound);
+    bool chance(unsigned percent);
+
+    std::string commonWord();
+    std::string syllableWord();
+    std::string digits(size_t count);
+    std::string year();
+    void decorate(std::string& password);
+
+    std::string wordWithSuffix();
+    std::string nameWithYear();
+    std::string keyboardWalk();
+    std::string numericPin();
+    std::string passphrase();
+    std::string randomString();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,105 @@
+#ifndef DAEMON_PROTOCOL_HPP
+#define DAEMON_PROTOCOL_HPP
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Wire format of PasswordCheckerDaemon. Every message is a frame of
+//
+//     u32 length | u8 type | u32 id | body
+//
+// where length counts the bytes after the length field and integers are little-endian. Requests
+// are answered in the order they arrive on a connection, and the id is echoed back, so clients may
+// pipeline as many requests as they like before reading responses.
+//
+//     CHECK request body:   the password bytes
+//     CHECK response body:  u8 status | u8 strength | u16 feature flags | u32 entropy * 100
+//     PING request body:    empty; the response has status OK and a zeroed body
+namespace DaemonProtocol {
+    constexpr size_t LENGTH_SIZE = 4;
+    constexpr size_t HEADER_SIZE = LENGTH_SIZE + 1 + 4;
+    constexpr size_t RESPONSE_BODY_SIZE = 8;
+    constexpr size_t RESPONSE_SIZE = HEADER_SIZE + RESPONSE_BODY_SIZE;
+    constexpr uint32_t MAX_PASSWORD_SIZE = 4096;
+
+    enum class MessageType : uint8_t {
+        CHECK = 1,
+        PING = 2
+    };
+
+    enum class Status : uint8_t {
+        OK = 0,
+        EMPTY_PASSWORD = 1,
+        BAD_REQUEST = 2,
+        TOO_LARGE = 3
+    };
+
+    enum FeatureFlag : uint16_t {
+        MEETS_MIN_LENGTH = 1 << 0,
+        HAS_UPPER = 1 << 1,
+        HAS_LOWER = 1 << 2,
+        HAS_DIGIT = 1 << 3,
+        HAS_SPECIAL = 1 << 4,
+        HAS_REPEATS = 1 << 5,
+        HAS_SEQUENCE = 1 << 6,
+        HAS_COMMON_WORD = 1 << 7,
+        IS_BREACHED = 1 << 8
+    };
+
+    struct Response {
+        MessageType type;
+        uint32_t id;
+        Status status;
+        uint8_t strength;  // PasswordStrength value
+        uint16_t flags;
+        uint32_t entropy_centibits;
+    };
+
+    inline void storeU32(char* out, uint32_t value) {
+        for (int i = 0; i < 4; ++i) out[i] = static_cast<char>(value >> (8 * i));
+    }
+
+    inline uint32_t loadU32(const char* in) {
+        uint32_t value = 0;
+        for (int i = 3; i >= 0; --i) value = (value << 8) | static_cast<unsigned char>(in[i]);
+        return value;
+    }
+
+    inline void appendRequest(std::string& out, MessageType type, uint32_t id, const char* data, size_t size) {
+        char header[HEADER_SIZE];
+        storeU32(header, static_cast<uint32_t>(HEADER_SIZE - LENGTH_SIZE + size));
+        header[4] = static_cast<char>(type);
+        storeU32(header + 5, id);
+        out.append(header, sizeof(header));
+        out.append(data, size);
+    }
+
+    inline void appendResponse(std::string& out, const Response& response) {
+        char frame[RESPONSE_SIZE];
+        storeU32(frame, static_cast<uint32_t>(RESPONSE_SIZE - LENGTH_SIZE));
+        frame[4] = static_cast<char>(response.type);
+        storeU32(frame + 5, response.id);
+        frame[9] = static_cast<char>(response.status);
+        frame[10] = static_cast<char>(response.strength);
+        frame[11] = static_cast<char>(response.flags & 0xFF);
+        frame[12] = static_cast<char>(response.flags >> 8);
+        storeU32(frame + 13, response.entropy_centibits);
+        out.append(frame, sizeof(frame));
+    }
+
+    // Parses one response frame from the start of data. Returns the bytes consumed, or 0 when the
+    // frame is not complete yet.
+    inline size_t parseResponse(const char* data, size_t size, Response& response) {
+        if (size < RESPONSE_SIZE) return 0;
+        response.type = static_cast<MessageType>(data[4]);
+        response.id = loadU32(data + 5);
+        response.status = static_cast<Status>(data[9]);
+        response.strength = static_cast<uint8_t>(data[10]);
+        response.flags = static_cast<uint16_t>(static_cast<unsigned char>(data[11]) |
+                                               (static_cast<unsigned char>(data[12]) << 8));
+        response.entropy_centibits = loadU32(data + 13);
+        return RESPONSE_SIZE;
+    }
+}
+
+#endif
\ No newline at end of file
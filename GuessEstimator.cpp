@@ -0,0 +1,407 @@
+#include "GuessEstimator.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <ctime>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+    struct Match {
+        uint32_t begin;
+        uint32_t end;
+        double log10_guesses;
+    };
+
+    // Buffers reused from call to call, so that estimating allocates only while they grow.
+    struct Scratch {
+        std::vector<Match> matches;
+        std::vector<WordMatch> found;
+        std::string plain;
+        std::vector<double> best_match;
+        std::vector<double> best_brute;
+    };
+
+    constexpr size_t MAX_REPEAT_PERIOD = 32;
+    // The block of a repeat is estimated on its own and is at most half as long as the text it
+    // repeats in, so nesting never goes deeper than the number of bits in MAX_REPEAT_PERIOD.
+    constexpr size_t MAX_DEPTH = 7;
+
+    Scratch& threadScratch(size_t depth) {
+        thread_local std::array<Scratch, MAX_DEPTH> scratch;
+        return scratch[depth];
+    }
+
+    constexpr double BRUTEFORCE_LOG10_PER_CHAR = 1.0;
+    constexpr double MIN_SUBMATCH_LOG10_SINGLE_CHAR = 1.0;    // 10 guesses
+    constexpr double MIN_SUBMATCH_LOG10_MULTI_CHAR = 1.69897; // 50 guesses
+    constexpr double SEQUENCE_PENALTY_LOG10 = 4.0;            // every extra piece adds 10^4 per piece
+    constexpr int MIN_YEAR_SPACE = 20;
+    constexpr double LOG10_DAYS_PER_YEAR = 2.5622929;         // log10(365)
+    constexpr double LOG10_DATE_SEPARATORS = 0.60206;         // log10(4)
+    constexpr size_t MAX_PIECES = 8;
+    // log10(l!) for l = 0..MAX_PIECES.
+    constexpr double LOG10_FACTORIAL[MAX_PIECES + 1] = {
+        0.0, 0.0, 0.30103, 0.7781513, 1.3802112, 2.0791812, 2.8573325, 3.7024305, 4.6055205
+    };
+
+    // The letter a l33t character most often stands for, or 0.
+    constexpr std::array<char, 256> makeLeetTable() {
+        std::array<char, 256> table{};
+        table['4'] = 'a'; table['@'] = 'a';
+        table['8'] = 'b';
+        table['('] = 'c'; table['{'] = 'c'; table['['] = 'c'; table['<'] = 'c';
+        table['3'] = 'e';
+        table['6'] = 'g'; table['9'] = 'g';
+        table['1'] = 'i'; table['!'] = 'i'; table['|'] = 'l';
+        table['0'] = 'o';
+        table['$'] = 's'; table['5'] = 's';
+        table['7'] = 't'; table['+'] = 't';
+        table['%'] = 'x';
+        table['2'] = 'z';
+        return table;
+    }
+
+    constexpr std::array<char, 256> kLeetTable = makeLeetTable();
+
+    inline bool isUpper(char c) { return c >= 'A' && c <= 'Z'; }
+    inline bool isLower(char c) { return c >= 'a' && c <= 'z'; }
+    inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+    int referenceYear() {
+        static const int year = 1970 + static_cast<int>(static_cast<double>(std::time(nullptr)) / (365.2425 * 86400.0));
+        return year;
+    }
+
+    // log10 of sum_{i=1..min(a,b)} C(a+b, i): the ways to place the rarer of two kinds of character.
+    double log10Variations(int a, int b) {
+        double sum = 0.0, term = 1.0;
+        int n = a + b;
+        for (int i = 1; i <= std::min(a, b); ++i) {
+            term = term * (n - i + 1) / i;
+            sum += term;
+        }
+        return std::log10(std::max(sum, 1.0));
+    }
+
+    double log10UppercaseVariations(const char* token, size_t size) {
+        int upper = 0, lower = 0;
+        for (size_t i = 0; i < size; ++i) {
+            upper += isUpper(token[i]);
+            lower += isLower(token[i]);
+        }
+        if (upper == 0) return 0.0;
+        // Capitalized, all caps and last-letter caps are the usual choices and cost one extra guess.
+        bool first_only = upper == 1 && isUpper(token[0]);
+        bool last_only = upper == 1 && isUpper(token[size - 1]);
+        if (lower == 0 || first_only || last_only) return std::log10(2.0);
+        return log10Variations(upper, lower);
+    }
+
+    double log10LeetVariations(const char* token, size_t size) {
+        double total = 0.0;
+        uint32_t done = 0;
+        for (size_t i = 0; i < size; ++i) {
+            char letter = kLeetTable[static_cast<unsigned char>(token[i])];
+            if (letter == 0 || (done & (1u << (letter - 'a')))) continue;
+            done |= 1u << (letter - 'a');
+            int substituted = 0, plain = 0;
+            for (size_t j = 0; j < size; ++j) {
+                substituted += kLeetTable[static_cast<unsigned char>(token[j])] == letter;
+                plain += (token[j] | 0x20) == letter;
+            }
+            total += plain == 0 ? std::log10(2.0) : log10Variations(substituted, plain);
+        }
+        return total;
+    }
+
+    void matchDictionary(std::string_view password, const WordMatcher& words, Scratch& scratch) {
+        if (words.empty()) return;
+        std::vector<Match>& matches = scratch.matches;
+        std::vector<WordMatch>& found = scratch.found;
+        found.clear();
+        words.findAll(password, found);
+        for (const WordMatch& m : found) {
+            size_t size = words.getWord(m.word_index).size();
+            double log10_rank = std::log10(static_cast<double>(m.word_index + 1));
+            matches.push_back({ static_cast<uint32_t>(m.position), static_cast<uint32_t>(m.position + size),
+                                log10_rank + log10UppercaseVariations(password.data() + m.position, size) });
+        }
+
+        // Undo the usual substitutions and match again; only matches that needed one count here.
+        std::string& plain = scratch.plain;
+        plain.assign(password.data(), password.size());
+        bool substituted = false;
+        for (char& c : plain) {
+            char letter = kLeetTable[static_cast<unsigned char>(c)];
+            if (letter != 0) {
+                c = letter;
+                substituted = true;
+            }
+        }
+        if (!substituted) return;
+        found.clear();
+        words.findAll(plain, found);
+        for (const WordMatch& m : found) {
+            size_t size = words.getWord(m.word_index).size();
+            const char* token = password.data() + m.position;
+            if (std::equal(token, token + size, plain.data() + m.position)) continue;
+            double log10_rank = std::log10(static_cast<double>(m.word_index + 1));
+            matches.push_back({ static_cast<uint32_t>(m.position), static_cast<uint32_t>(m.position + size),
+                                log10_rank + log10UppercaseVariations(token, size) + log10LeetVariations(token, size) });
+        }
+    }
+
+    double estimate(std::string_view password, const WordMatcher& words, size_t depth);
+
+    // Whether block is not itself some shorter block written several times.
+    bool isPrimitive(const char* block, size_t size) {
+        for (size_t period = 1; 2 * period <= size; ++period) {
+            if (size % period == 0 && std::memcmp(block, block + period, size - period) == 0) return false;
+        }
+        return true;
+    }
+
+    // "aaaa", "abab", "dragon12dragon12": a block of at most MAX_REPEAT_PERIOD characters written two
+    // or more times in a row. For each period, a run of characters equal to the character one period
+    // on that is at least a period long extends the block before it; the match is the whole periods
+    // the run covers and costs the guesses for its block times the number of repeats. Blocks that
+    // repeat a shorter block are left to the shorter period. Capping the period keeps the work
+    // linear in the length of the password.
+    void matchRepeats(std::string_view password, const WordMatcher& words, size_t depth, Scratch& scratch) {
+        size_t n = password.size();
+        const char* text = password.data();
+        for (size_t period = 1; period <= std::min(MAX_REPEAT_PERIOD, n / 2); ++period) {
+            size_t run = 0;
+            for (size_t i = 0; i + period <= n; ++i) {
+                if (i + period < n && text[i] == text[i + period]) {
+                    ++run;
+                    continue;
+                }
+                size_t start = i - run;
+                if (run >= period && isPrimitive(text + start, period)) {
+                    size_t count = (run + period) / period;
+                    size_t length = count * period;
+                    // Whole periods aligned to the start of the run and, when they differ, to its end.
+                    for (size_t begin : { start, i + period - length }) {
+                        double base = estimate(password.substr(begin, period), words, depth + 1);
+                        scratch.matches.push_back({ static_cast<uint32_t>(begin), static_cast<uint32_t>(begin + length),
+                                                    base + std::log10(static_cast<double>(count)) });
+                        if (length == run + period) break;
+                    }
+                }
+                run = 0;
+            }
+        }
+    }
+
+    double log10SequenceGuesses(char first, size_t length, bool ascending) {
+        double base;
+        if (first == 'a' || first == 'A' || first == 'z' || first == 'Z' || first == '0' || first == '1' || first == '9') base = 4.0;
+        else if (isDigit(first)) base = 10.0;
+        else base = 26.0;
+        if (!ascending) base *= 2.0;
+        return std::log10(base * static_cast<double>(length));
+    }
+
+    // Runs of three or more letters or digits of one class with a constant step of 1 to 5.
+    void matchSequences(std::string_view password, std::vector<Match>& matches) {
+        size_t n = password.size();
+        auto sameClass = [](char a, char b) {
+            return (isLower(a) && isLower(b)) || (isUpper(a) && isUpper(b)) || (isDigit(a) && isDigit(b));
+        };
+        size_t start = 0;
+        int delta = 0;
+        for (size_t i = 1; i <= n; ++i) {
+            int step = i < n ? password[i] - password[i - 1] : 0;
+            bool continues = i < n && step == delta && delta != 0 && sameClass(password[i], password[i - 1]);
+            if (continues) continue;
+            if (i - start >= 3 && delta != 0) {
+                matches.push_back({ static_cast<uint32_t>(start), static_cast<uint32_t>(i),
+                                    log10SequenceGuesses(password[start], i - start, delta > 0) });
+            }
+            start = i - 1;
+            delta = (i < n && std::abs(step) <= 5 && sameClass(password[i], password[i - 1])) ? step : 0;
+        }
+    }
+
+    double log10YearGuesses(int year) {
+        return std::log10(static_cast<double>(std::max(std::abs(year - referenceYear()), MIN_YEAR_SPACE)));
+    }
+
+    int parseDigits(const char* digits, size_t size) {
+        int value = 0;
+        for (size_t i = 0; i < size; ++i) value = value * 10 + (digits[i] - '0');
+        return value;
+    }
+
+    int expandYear(int year, size_t digits) {
+        if (digits == 4) return year;
+        return year > 50 ? 1900 + year : 2000 + year;
+    }
+
+    // Smallest year distance over the readings of (a, b, c) as day, month and year in either order,
+    // or -1 when no reading is a valid date.
+    int bestYearDistance(const int parts[3], const size_t sizes[3]) {
+        if (parts[1] < 1 || parts[1] > 31) return -1;
+        int best = -1;
+        const int orders[2][3] = { { 2, 0, 1 }, { 0, 1, 2 } };
+        for (const auto& order : orders) {
+            size_t year_digits = sizes[order[0]];
+            if (year_digits != 2 && year_digits != 4) continue;
+            int year = expandYear(parts[order[0]], year_digits);
+            if (year < 1000 || year > 2050) continue;
+            int a = parts[order[1]], b = parts[order[2]];
+            bool valid = (a >= 1 && a <= 31 && b >= 1 && b <= 12) || (b >= 1 && b <= 31 && a >= 1 && a <= 12);
+            if (!valid) continue;
+            int distance = std::max(std::abs(year - referenceYear()), MIN_YEAR_SPACE);
+            if (best < 0 || distance < best) best = distance;
+        }
+        return best;
+    }
+
+    // Years, digit-only dates such as 311299 and dates with separators such as 31.12.1999, starting
+    // at any digit.
+    void matchDates(std::string_view password, std::vector<Match>& matches) {
+        // Where to cut 4 to 8 digits into day, month and year.
+        static const uint8_t SPLITS[9][4][2] = {
+            {}, {}, {}, {},
+            { { 1, 2 }, { 2, 3 } },
+            { { 1, 3 }, { 2, 3 } },
+            { { 1, 2 }, { 2, 4 }, { 4, 5 } },
+            { { 1, 3 }, { 2, 3 }, { 4, 5 }, { 4, 6 } },
+            { { 2, 4 }, { 4, 6 } }
+        };
+        size_t n = password.size();
+        const char* text = password.data();
+
+        // Digits from i to the end of the run, carried over from i - 1 so a long run is scanned once.
+        size_t run = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if (run > 0) --run;
+            if (!isDigit(text[i])) continue;
+
+            if (run == 0) {
+                while (i + run < n && isDigit(text[i + run])) ++run;
+            }
+            for (size_t length = 4; length <= std::min<size_t>(run, 8); ++length) {
+                if (length == 4) {
+                    int year = parseDigits(text + i, 4);
+                    if (year >= 1900 && year <= 2099) {
+                        matches.push_back({ static_cast<uint32_t>(i), static_cast<uint32_t>(i + 4), log10YearGuesses(year) });
+                    }
+                }
+                int best = -1;
+                for (const auto& split : SPLITS[length]) {
+                    if (split[0] == 0) break;
+                    size_t sizes[3] = { split[0], size_t(split[1] - split[0]), length - split[1] };
+                    int parts[3] = { parseDigits(text + i, sizes[0]), parseDigits(text + i + split[0], sizes[1]),
+                                     parseDigits(text + i + split[1], sizes[2]) };
+                    int distance = bestYearDistance(parts, sizes);
+                    if (distance > 0 && (best < 0 || distance < best)) best = distance;
+                }
+                if (best > 0) {
+                    matches.push_back({ static_cast<uint32_t>(i), static_cast<uint32_t>(i + length),
+                                        std::log10(static_cast<double>(best)) + LOG10_DAYS_PER_YEAR });
+                }
+            }
+
+            // d{1,4} sep d{1,2} sep d{1,4} with the same separator twice, such as 31.12.1999.
+            size_t first = run;
+            if (first <= 4 && i + first < n) {
+                char separator = text[i + first];
+                if (separator == ' ' || separator == '/' || separator == '\\' || separator == '_' ||
+                    separator == '.' || separator == '-') {
+                    size_t j = i + first + 1, second = 0;
+                    while (j + second < n && isDigit(text[j + second]) && second < 3) ++second;
+                    size_t k = j + second + 1, third = 0;
+                    if (second >= 1 && second <= 2 && k - 1 < n && text[k - 1] == separator) {
+                        while (k + third < n && isDigit(text[k + third]) && third < 5) ++third;
+                        if (third >= 1 && third <= 4) {
+                            size_t sizes[3] = { first, second, third };
+                            int parts[3] = { parseDigits(text + i, first), parseDigits(text + j, second),
+                                             parseDigits(text + k, third) };
+                            int distance = bestYearDistance(parts, sizes);
+                            if (distance > 0) {
+                                matches.push_back({ static_cast<uint32_t>(i), static_cast<uint32_t>(k + third),
+                                                    std::log10(static_cast<double>(distance)) + LOG10_DAYS_PER_YEAR +
+                                                    LOG10_DATE_SEPARATORS });
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    double estimate(std::string_view password, const WordMatcher& words, size_t depth) {
+        size_t n = password.size();
+        if (n == 0) return 0.0;
+        Scratch& scratch = threadScratch(depth);
+        std::vector<Match>& matches = scratch.matches;
+        matches.clear();
+        matchDictionary(password, words, scratch);
+        matchRepeats(password, words, depth, scratch);
+        matchSequences(password, matches);
+        matchDates(password, matches);
+        for (Match& m : matches) {
+            if (m.end - m.begin < n) {
+                double floor = m.end - m.begin == 1 ? MIN_SUBMATCH_LOG10_SINGLE_CHAR : MIN_SUBMATCH_LOG10_MULTI_CHAR;
+                m.log10_guesses = std::max(m.log10_guesses, floor);
+            }
+        }
+        std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) { return a.end < b.end; });
+
+        // best_match[k][l] and best_brute[k][l]: the smallest log10 product of guesses over ways to
+        // cover the first k characters with l pieces, ending in a pattern match or in a brute-forced
+        // run. Consecutive brute-forced characters form one piece.
+        constexpr double INF = std::numeric_limits<double>::infinity();
+        constexpr size_t L = MAX_PIECES + 1;
+        std::vector<double>& best_match = scratch.best_match;
+        std::vector<double>& best_brute = scratch.best_brute;
+        best_match.assign((n + 1) * L, INF);
+        best_brute.assign((n + 1) * L, INF);
+        auto best = [&](size_t k, size_t l) { return std::min(best_match[k * L + l], best_brute[k * L + l]); };
+        best_match[0] = 0.0;
+
+        size_t next = 0;
+        for (size_t k = 1; k <= n; ++k) {
+            for (size_t l = 1; l < L; ++l) {
+                double extend = best_brute[(k - 1) * L + l] + BRUTEFORCE_LOG10_PER_CHAR;
+                double start = best_match[(k - 1) * L + l - 1] + BRUTEFORCE_LOG10_PER_CHAR;
+                best_brute[k * L + l] = std::min(extend, start);
+            }
+            for (; next < matches.size() && matches[next].end == k; ++next) {
+                const Match& m = matches[next];
+                for (size_t l = 1; l < L; ++l) {
+                    double candidate = best(m.begin, l - 1) + m.log10_guesses;
+                    if (candidate < best_match[k * L + l]) best_match[k * L + l] = candidate;
+                }
+            }
+        }
+
+        // guesses = l! * product + (10^4)^(l - 1), minimized over l.
+        double result = INF;
+        for (size_t l = 1; l < L; ++l) {
+            double product = best(n, l);
+            if (product == INF) continue;
+            double a = LOG10_FACTORIAL[l] + product;
+            double b = SEQUENCE_PENALTY_LOG10 * static_cast<double>(l - 1);
+            double high = std::max(a, b), low = std::min(a, b);
+            result = std::min(result, high + std::log10(1.0 + std::pow(10.0, low - high)));
+        }
+        return result;
+    }
+}
+
+namespace GuessEstimator {
+    double log10Guesses(std::string_view password, const WordMatcher& words) {
+        Trace::Span span("GuessEstimator::log10Guesses");
+        return estimate(password, words, 0);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#ifndef GUESS_ESTIMATOR_HPP
+#define GUESS_ESTIMATOR_HPP
+#include <string_view>
+#include "WordMatcher.hpp"
+
+// Estimates how many guesses an attacker who knows common password patterns needs, in the spirit
+// of zxcvbn. The password is matched against dictionary words (case and l33t variations
+// included), repeats of blocks of up to 32 characters, alphabetic and numeric sequences such as
+// "abc" or "9753", years and dates. A dynamic program then picks the decomposition into matches and brute-forced
+// gaps that is cheapest to guess, charging extra for every additional piece.
+namespace GuessEstimator {
+    // Words earlier in the matcher's list are taken to be more common and cheaper to guess.
+    double log10Guesses(std::string_view password, const WordMatcher& words);
+}
+
+#endif
\ No newline at end of file
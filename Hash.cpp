@@ -0,0 +1,327 @@
+#include "Hash.hpp"
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+    inline uint32_t rotl(uint32_t x, int n) {
+        return (x << n) | (x >> (32 - n));
+    }
+
+    void sha1Block(uint32_t state[5], const uint8_t* block) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = (uint32_t(block[i * 4]) << 24) | (uint32_t(block[i * 4 + 1]) << 16) |
+                (uint32_t(block[i * 4 + 2]) << 8) | uint32_t(block[i * 4 + 3]);
+        }
+        for (int i = 16; i < 80; ++i) w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+        for (int i = 0; i < 80; ++i) {
+            uint32_t f, k;
+            if (i < 20) { f = (b & c) | (~b & d); k = 0x5A827999; }
+            else if (i < 40) { f = b ^ c ^ d; k = 0x6ED9EBA1; }
+            else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+            else { f = b ^ c ^ d; k = 0xCA62C1D6; }
+            uint32_t temp = rotl(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = rotl(b, 30);
+            b = a;
+            a = temp;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+    }
+
+    void md4Block(uint32_t state[4], const uint8_t* block) {
+        uint32_t x[16];
+        for (int i = 0; i < 16; ++i) {
+            x[i] = uint32_t(block[i * 4]) | (uint32_t(block[i * 4 + 1]) << 8) |
+                (uint32_t(block[i * 4 + 2]) << 16) | (uint32_t(block[i * 4 + 3]) << 24);
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        auto f = [](uint32_t x, uint32_t y, uint32_t z) { return (x & y) | (~x & z); };
+        auto g = [](uint32_t x, uint32_t y, uint32_t z) { return (x & y) | (x & z) | (y & z); };
+        auto h = [](uint32_t x, uint32_t y, uint32_t z) { return x ^ y ^ z; };
+
+        static const int r1[4] = { 3, 7, 11, 19 };
+        for (int i = 0; i < 16; ++i) {
+            uint32_t t = a + f(b, c, d) + x[i];
+            a = d; d = c; c = b; b = rotl(t, r1[i % 4]);
+        }
+        static const int r2[4] = { 3, 5, 9, 13 };
+        static const int o2[16] = { 0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15 };
+        for (int i = 0; i < 16; ++i) {
+            uint32_t t = a + g(b, c, d) + x[o2[i]] + 0x5A827999;
+            a = d; d = c; c = b; b = rotl(t, r2[i % 4]);
+        }
+        static const int r3[4] = { 3, 9, 11, 15 };
+        static const int o3[16] = { 0, 8, 4, 12, 2, 10, 6, 14, 1, 9, 5, 13, 3, 11, 7, 15 };
+        for (int i = 0; i < 16; ++i) {
+            uint32_t t = a + h(b, c, d) + x[o3[i]] + 0x6ED9EBA1;
+            a = d; d = c; c = b; b = rotl(t, r3[i % 4]);
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+    }
+
+    // Appends the Merkle-Damgard padding shared by SHA-1 (big-endian length) and MD4 (little-endian).
+    template <typename BlockFn>
+    void runPadded(const uint8_t* data, size_t length, bool big_endian_length, BlockFn&& block_fn) {
+        size_t full = length / 64;
+        for (size_t i = 0; i < full; ++i) block_fn(data + i * 64);
+
+        uint8_t tail[128] = {};
+        size_t rest = length % 64;
+        std::memcpy(tail, data + full * 64, rest);
+        tail[rest] = 0x80;
+        size_t tail_length = rest < 56 ? 64 : 128;
+        uint64_t bits = uint64_t(length) * 8;
+        for (int i = 0; i < 8; ++i) {
+            size_t index = big_endian_length ? tail_length - 1 - i : tail_length - 8 + i;
+            tail[index] = static_cast<uint8_t>(bits >> (8 * i));
+        }
+        block_fn(tail);
+        if (tail_length == 128) block_fn(tail + 64);
+    }
+
+    inline uint64_t rotl64(uint64_t x, int n) {
+        return (x << n) | (x >> (64 - n));
+    }
+
+    inline uint64_t loadLittleEndian64(const uint8_t* bytes) {
+        uint64_t value = 0;
+        for (int i = 7; i >= 0; --i) value = (value << 8) | bytes[i];
+        return value;
+    }
+
+    inline void sipRound(uint64_t& v0, uint64_t& v1, uint64_t& v2, uint64_t& v3) {
+        v0 += v1; v1 = rotl64(v1, 13); v1 ^= v0; v0 = rotl64(v0, 32);
+        v2 += v3; v3 = rotl64(v3, 16); v3 ^= v2;
+        v0 += v3; v3 = rotl64(v3, 21); v3 ^= v0;
+        v2 += v1; v1 = rotl64(v1, 17); v1 ^= v2; v2 = rotl64(v2, 32);
+    }
+
+    constexpr uint64_t XXH_PRIME1 = 0x9E3779B185EBCA87ULL;
+    constexpr uint64_t XXH_PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr uint64_t XXH_PRIME3 = 0x165667B19E3779F9ULL;
+    constexpr uint64_t XXH_PRIME4 = 0x85EBCA77C2B2AE63ULL;
+    constexpr uint64_t XXH_PRIME5 = 0x27D4EB2F165667C5ULL;
+
+    inline uint64_t xxhRound(uint64_t acc, uint64_t input) {
+        acc += input * XXH_PRIME2;
+        return rotl64(acc, 31) * XXH_PRIME1;
+    }
+
+    inline uint64_t xxhMerge(uint64_t hash, uint64_t acc) {
+        hash ^= xxhRound(0, acc);
+        return hash * XXH_PRIME1 + XXH_PRIME4;
+    }
+
+    int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+}
+
+namespace Hash {
+    Sha1Digest sha1(const void* data, size_t length) {
+        uint32_t state[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+        runPadded(static_cast<const uint8_t*>(data), length, true,
+                  [&state](const uint8_t* block) { sha1Block(state, block); });
+
+        Sha1Digest digest;
+        for (int i = 0; i < 5; ++i) {
+            digest[i * 4] = static_cast<uint8_t>(state[i] >> 24);
+            digest[i * 4 + 1] = static_cast<uint8_t>(state[i] >> 16);
+            digest[i * 4 + 2] = static_cast<uint8_t>(state[i] >> 8);
+            digest[i * 4 + 3] = static_cast<uint8_t>(state[i]);
+        }
+        return digest;
+    }
+
+    Sha1Digest sha1(std::string_view data) {
+        return sha1(data.data(), data.size());
+    }
+
+    NtlmDigest ntlm(std::string_view password) {
+        // Every input byte yields at most two bytes of UTF-16, so typical passwords fit on the stack.
+        uint8_t stack_buffer[512];
+        std::vector<uint8_t> heap_buffer;
+        uint8_t* utf16 = stack_buffer;
+        if (password.size() * 2 > sizeof(stack_buffer)) {
+            heap_buffer.resize(password.size() * 2);
+            utf16 = heap_buffer.data();
+        }
+        size_t utf16_size = 0;
+        auto put_unit = [utf16, &utf16_size](uint32_t unit) {
+            utf16[utf16_size++] = static_cast<uint8_t>(unit);
+            utf16[utf16_size++] = static_cast<uint8_t>(unit >> 8);
+        };
+
+        size_t i = 0;
+        while (i < password.size()) {
+            unsigned char c = static_cast<unsigned char>(password[i]);
+            uint32_t code_point = c;
+            size_t extra = 0;
+            if (c >= 0xF0 && c < 0xF8) { code_point = c & 0x07; extra = 3; }
+            else if (c >= 0xE0 && c < 0xF0) { code_point = c & 0x0F; extra = 2; }
+            else if (c >= 0xC0 && c < 0xE0) { code_point = c & 0x1F; extra = 1; }
+
+            bool valid = extra == 0 || i + extra < password.size();
+            for (size_t k = 1; valid && k <= extra; ++k) {
+                unsigned char next = static_cast<unsigned char>(password[i + k]);
+                if ((next & 0xC0) != 0x80) valid = false;
+                else code_point = (code_point << 6) | (next & 0x3F);
+            }
+            if (!valid) {
+                // Not UTF-8: fall back to treating the byte as Latin-1.
+                code_point = c;
+                extra = 0;
+            }
+
+            if (code_point >= 0x10000) {
+                code_point -= 0x10000;
+                put_unit(0xD800 | (code_point >> 10));
+                put_unit(0xDC00 | (code_point & 0x3FF));
+            } else {
+                put_unit(code_point);
+            }
+            i += extra + 1;
+        }
+
+        uint32_t state[4] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476 };
+        runPadded(utf16, utf16_size, false,
+                  [&state](const uint8_t* block) { md4Block(state, block); });
+
+        NtlmDigest digest;
+        for (int k = 0; k < 4; ++k) {
+            digest[k * 4] = static_cast<uint8_t>(state[k]);
+            digest[k * 4 + 1] = static_cast<uint8_t>(state[k] >> 8);
+            digest[k * 4 + 2] = static_cast<uint8_t>(state[k] >> 16);
+            digest[k * 4 + 3] = static_cast<uint8_t>(state[k] >> 24);
+        }
+        return digest;
+    }
+
+    uint64_t sipHash24(const SipKey& key, const void* data, size_t length) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        uint64_t k0 = loadLittleEndian64(key.data());
+        uint64_t k1 = loadLittleEndian64(key.data() + 8);
+        uint64_t v0 = k0 ^ 0x736F6D6570736575ULL;
+        uint64_t v1 = k1 ^ 0x646F72616E646F6DULL;
+        uint64_t v2 = k0 ^ 0x6C7967656E657261ULL;
+        uint64_t v3 = k1 ^ 0x7465646279746573ULL;
+
+        size_t full = length & ~size_t(7);
+        for (size_t i = 0; i < full; i += 8) {
+            uint64_t m = loadLittleEndian64(bytes + i);
+            v3 ^= m;
+            sipRound(v0, v1, v2, v3);
+            sipRound(v0, v1, v2, v3);
+            v0 ^= m;
+        }
+
+        uint64_t last = uint64_t(length & 0xFF) << 56;
+        for (size_t i = 0; i < (length & 7); ++i) last |= uint64_t(bytes[full + i]) << (8 * i);
+        v3 ^= last;
+        sipRound(v0, v1, v2, v3);
+        sipRound(v0, v1, v2, v3);
+        v0 ^= last;
+
+        v2 ^= 0xFF;
+        for (int i = 0; i < 4; ++i) sipRound(v0, v1, v2, v3);
+        return v0 ^ v1 ^ v2 ^ v3;
+    }
+
+    SipKey randomSipKey() {
+        std::random_device device;
+        SipKey key;
+        for (size_t i = 0; i < key.size(); i += 4) {
+            uint32_t word = device();
+            std::memcpy(key.data() + i, &word, 4);
+        }
+        return key;
+    }
+
+    uint64_t xxh64(const void* data, size_t length, uint64_t seed) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        const uint8_t* end = bytes + length;
+        uint64_t hash;
+
+        if (length >= 32) {
+            uint64_t v1 = seed + XXH_PRIME1 + XXH_PRIME2;
+            uint64_t v2 = seed + XXH_PRIME2;
+            uint64_t v3 = seed;
+            uint64_t v4 = seed - XXH_PRIME1;
+            const uint8_t* limit = end - 32;
+            do {
+                v1 = xxhRound(v1, loadLittleEndian64(bytes));
+                v2 = xxhRound(v2, loadLittleEndian64(bytes + 8));
+                v3 = xxhRound(v3, loadLittleEndian64(bytes + 16));
+                v4 = xxhRound(v4, loadLittleEndian64(bytes + 24));
+                bytes += 32;
+            } while (bytes <= limit);
+            hash = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+            hash = xxhMerge(hash, v1);
+            hash = xxhMerge(hash, v2);
+            hash = xxhMerge(hash, v3);
+            hash = xxhMerge(hash, v4);
+        } else {
+            hash = seed + XXH_PRIME5;
+        }
+
+        hash += length;
+        for (; bytes + 8 <= end; bytes += 8) {
+            hash ^= xxhRound(0, loadLittleEndian64(bytes));
+            hash = rotl64(hash, 27) * XXH_PRIME1 + XXH_PRIME4;
+        }
+        if (bytes + 4 <= end) {
+            uint64_t word = uint64_t(bytes[0]) | (uint64_t(bytes[1]) << 8) | (uint64_t(bytes[2]) << 16) | (uint64_t(bytes[3]) << 24);
+            hash ^= word * XXH_PRIME1;
+            hash = rotl64(hash, 23) * XXH_PRIME2 + XXH_PRIME3;
+            bytes += 4;
+        }
+        for (; bytes < end; ++bytes) {
+            hash ^= *bytes * XXH_PRIME5;
+            hash = rotl64(hash, 11) * XXH_PRIME1;
+        }
+
+        hash ^= hash >> 33;
+        hash *= XXH_PRIME2;
+        hash ^= hash >> 29;
+        hash *= XXH_PRIME3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    bool parseHex(const char* hex, size_t byte_count, uint8_t* out) {
+        for (size_t i = 0; i < byte_count; ++i) {
+            int high = hexValue(hex[i * 2]);
+            int low = hexValue(hex[i * 2 + 1]);
+            if (high < 0 || low < 0) return false;
+            out[i] = static_cast<uint8_t>((high << 4) | low);
+        }
+        return true;
+    }
+
+    std::string toHex(const uint8_t* data, size_t length) {
+        static const char digits[] = "0123456789ABCDEF";
+        std::string hex(length * 2, '0');
+        for (size_t i = 0; i < length; ++i) {
+            hex[i * 2] = digits[data[i] >> 4];
+            hex[i * 2 + 1] = digits[data[i] & 0x0F];
+        }
+        return hex;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#ifndef HASH_HPP
+#define HASH_HPP
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Hash {
+    using Sha1Digest = std::array<uint8_t, 20>;
+    using NtlmDigest = std::array<uint8_t, 16>;
+
+    Sha1Digest sha1(const void* data, size_t length);
+    Sha1Digest sha1(std::string_view data);
+
+    // MD4 of the password encoded as UTF-16LE, the format Windows stores NT hashes in.
+    NtlmDigest ntlm(std::string_view password);
+
+    using SipKey = std::array<uint8_t, 16>;
+
+    // SipHash-2-4: a fast keyed hash. Without the key, outputs cannot be computed or inverted by
+    // guessing inputs, so it is safe to keep where a plain digest of a password would not be.
+    uint64_t sipHash24(const SipKey& key, const void* data, size_t length);
+    SipKey randomSipKey();
+
+    // XXH64: a fast unkeyed checksum for detecting corrupt files, not for anything secret.
+    uint64_t xxh64(const void* data, size_t length, uint64_t seed = 0);
+
+    bool parseHex(const char* hex, size_t byte_count, uint8_t* out);
+    std::string toHex(const uint8_t* data, size_t length);
+}
+
+#endif
\ No newline at end of file
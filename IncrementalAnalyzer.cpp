@@ -0,0 +1,131 @@
+#include "IncrementalAnalyzer.hpp"
+#include "CharClass.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr uint8_t kSequenceClasses = CharClass::UPPER | CharClass::LOWER | CharClass::DIGIT;
+
+    // Index into the per-class counters; classes are single bits, bytes without one return 4.
+    inline size_t classIndex(unsigned char c) {
+        switch (CharClass::of(c)) {
+        case CharClass::UPPER: return 0;
+        case CharClass::LOWER: return 1;
+        case CharClass::DIGIT: return 2;
+        case CharClass::SPECIAL: return 3;
+        default: return 4;
+        }
+    }
+}
+
+IncrementalAnalyzer::IncrementalAnalyzer(const ConfigManager& config)
+    : config_(config),
+    generation_(config.getGeneration()),
+    matcher_(&config.getWordMatcher()) {
+    clear();
+}
+
+void IncrementalAnalyzer::push(char ch) {
+    refreshMatcher();
+    append(ch);
+}
+
+void IncrementalAnalyzer::pop() {
+    if (text_.empty()) return;
+    refreshMatcher();
+
+    unsigned char c = static_cast<unsigned char>(text_.back());
+    const Frame& frame = frames_.back();
+    if (--counts_[c] == 0) --unique_chars_;
+    size_t cls = classIndex(c);
+    if (cls < class_counts_.size()) --class_counts_[cls];
+    sequence_count_ -= frame.ends_sequence;
+    word_count_ -= frame.ends_word;
+    non_ascii_count_ -= c >= 0x80;
+
+    text_.pop_back();
+    frames_.pop_back();
+}
+
+void IncrementalAnalyzer::clear() {
+    text_.clear();
+    frames_.clear();
+    counts_.fill(0);
+    class_counts_.fill(0);
+    unique_chars_ = 0;
+    sequence_count_ = 0;
+    word_count_ = 0;
+    non_ascii_count_ = 0;
+}
+
+void IncrementalAnalyzer::assign(std::string_view text) {
+    refreshMatcher();
+    size_t common = std::mismatch(text_.begin(), text_.begin() + std::min(text_.size(), text.size()),
+                                  text.begin()).first - text_.begin();
+    while (text_.size() > common) pop();
+    for (size_t i = common; i < text.size(); ++i) append(text[i]);
+}
+
+const std::string& IncrementalAnalyzer::text() const {
+    return text_;
+}
+
+bool IncrementalAnalyzer::isAscii() const {
+    return non_ascii_count_ == 0;
+}
+
+PasswordFeatures IncrementalAnalyzer::features() const {
+    PasswordFeatures features;
+    features.length = text_.size();
+    features.unique_chars = unique_chars_;
+    features.has_upper = class_counts_[0] != 0;
+    features.has_lower = class_counts_[1] != 0;
+    features.has_digit = class_counts_[2] != 0;
+    features.has_special = class_counts_[3] != 0;
+    features.has_repeats = unique_chars_ != text_.size();
+    features.has_sequence = sequence_count_ != 0;
+    features.has_common_word = word_count_ != 0;
+    if (features.length > 0) {
+        features.entropy = features.length * std::log2(static_cast<double>(unique_chars_));
+    }
+    return features;
+}
+
+void IncrementalAnalyzer::refreshMatcher() {
+    if (config_.getGeneration() == generation_) return;
+    generation_ = config_.getGeneration();
+    matcher_ = &config_.getWordMatcher();
+
+    // The stored automaton states belong to the old matcher; replay the text through the new one.
+    std::string text;
+    text.swap(text_);
+    clear();
+    for (char ch : text) append(ch);
+}
+
+void IncrementalAnalyzer::append(char ch) {
+    unsigned char c = static_cast<unsigned char>(ch);
+    Frame frame;
+    frame.matcher_state = matcher_->advance(frames_.empty() ? WordMatcher::START_STATE : frames_.back().matcher_state, ch);
+    frame.ends_word = matcher_->endsWord(frame.matcher_state);
+    frame.ends_sequence = false;
+    size_t size = text_.size();
+    if (size >= 2) {
+        unsigned char prev2 = static_cast<unsigned char>(text_[size - 2]);
+        unsigned char prev1 = static_cast<unsigned char>(text_[size - 1]);
+        if (prev1 == prev2 + 1 && c == prev2 + 2) {
+            uint8_t cls = CharClass::of(c);
+            frame.ends_sequence = (cls & kSequenceClasses) && CharClass::of(prev2) == cls && CharClass::of(prev1) == cls;
+        }
+    }
+
+    if (counts_[c]++ == 0) ++unique_chars_;
+    size_t cls = classIndex(c);
+    if (cls < class_counts_.size()) ++class_counts_[cls];
+    sequence_count_ += frame.ends_sequence;
+    word_count_ += frame.ends_word;
+    non_ascii_count_ += c >= 0x80;
+
+    text_.push_back(ch);
+    frames_.push_back(frame);
+}
\ No newline at end of file
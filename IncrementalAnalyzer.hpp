@@ -0,0 +1,58 @@
+#ifndef INCREMENTAL_ANALYZER_HPP
+#define INCREMENTAL_ANALYZER_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ConfigManager.hpp"
+#include "PasswordAnalyzer.hpp"
+
+// Analysis of a password that is being typed. Alongside the text it keeps running counts (classes,
+// a byte histogram, sequence and word hits) and the word automaton state after every character,
+// so appending or erasing a character costs O(1) and replacing the text costs O(k) in the length
+// of the changed tail, whatever the dictionary size.
+//
+// features() returns exactly what PasswordAnalyzer::analyze would for text() with
+// TextEncoding::BYTES. When the ConfigManager's word list changes, the next edit replays the text
+// against the new matcher.
+class IncrementalAnalyzer {
+public:
+    explicit IncrementalAnalyzer(const ConfigManager& config);
+
+    void push(char ch);
+    void pop();
+    void clear();
+    // Replaces the text, keeping the work already done for the prefix it shares with the old one.
+    void assign(std::string_view text);
+
+    const std::string& text() const;
+    // Whether every byte is below 0x80, in which case TextEncoding::UTF8 changes nothing.
+    bool isAscii() const;
+    PasswordFeatures features() const;
+
+private:
+    struct Frame {
+        uint32_t matcher_state;
+        bool ends_sequence;
+        bool ends_word;
+    };
+
+    const ConfigManager& config_;
+    uint64_t generation_;
+    const WordMatcher* matcher_;
+    std::string text_;
+    std::vector<Frame> frames_;
+    std::array<uint32_t, 256> counts_;
+    std::array<size_t, 4> class_counts_;
+    size_t unique_chars_;
+    size_t sequence_count_;
+    size_t word_count_;
+    size_t non_ascii_count_;
+
+    void refreshMatcher();
+    void append(char ch);
+};
+
+#endif
\ No newline at end of file
@@ -1,130 +1,413 @@
-#include "Logger.hpp"
-#include <iostream>
-#include <ctime>
-#include <iomanip>
-#include <sstream>
-#include <chrono>
-
-Logger::Logger(const std::string& filename)
-    : filename_(filename),
-    min_level_(LogLevel::INFO),
-    include_timestamp_(true),
-    console_output_(false) {
-    file_.open(filename, std::ios::app);
-    if (!file_.is_open()) throw std::runtime_error("Failed to open log file: " + filename);
-}
-
-Logger::~Logger() {
-    if (file_.is_open()) file_.close();
-}
-
-Logger::Logger(Logger&& other) noexcept
-    : filename_(std::move(other.filename_)),
-    file_(std::move(other.file_)),
-    min_level_(other.min_level_),
-    include_timestamp_(other.include_timestamp_),
-    console_output_(other.console_output_) {
-}
-
-Logger& Logger::operator=(Logger&& other) noexcept {
-    if (this != &other) {
-        if (file_.is_open()) file_.close();
-        filename_ = std::move(other.filename_);
-        file_ = std::move(other.file_);
-        min_level_ = other.min_level_;
-        include_timestamp_ = other.include_timestamp_;
-        console_output_ = other.console_output_;
-    }
-    return *this;
-}
-
-void Logger::log(const std::string& message, LogLevel level) {
-    if (shouldLog(level)) writeLog(message, level);
-}
-
-void Logger::debug(const std::string& message) {
-    log(message, LogLevel::DEBUG);
-}
-
-void Logger::info(const std::string& message) {
-    log(message, LogLevel::INFO);
-}
-
-void Logger::warning(const std::string& message) {
-    log(message, LogLevel::WARNING);
-}
-
-void Logger::error(const std::string& message) {
-    log(message, LogLevel::ERROR);
-}
-
-void Logger::critical(const std::string& message) {
-    log(message, LogLevel::CRITICAL);
-}
-
-void Logger::setLogLevel(LogLevel level) {
-    min_level_ = level;
-}
-
-LogLevel Logger::getLogLevel() const {
-    return min_level_;
-}
-
-void Logger::enableTimestamp(bool enable) {
-    include_timestamp_ = enable;
-}
-
-void Logger::enableConsoleOutput(bool enable) {
-    console_output_ = enable;
-}
-
-void Logger::flush() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    file_.flush();
-}
-
-std::string Logger::getCurrentTimestamp() const {
-    auto now = std::chrono::system_clock::now();
-    auto time_t_now = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()
-    ).count() % 1000;
-
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&time_t_now), "%Y-%m-%d %H:%M:%S");
-    ss << '.' << std::setfill('0') << std::setw(3) << ms;
-    return ss.str();
-}
-
-std::string Logger::logLevelToString(LogLevel level) const {
-    switch (level) {
-        case LogLevel::DEBUG: return "DEBUG";
-        case LogLevel::INFO: return "INFO";
-        case LogLevel::WARNING: return "WARNING";
-        case LogLevel::ERROR: return "ERROR";
-        case LogLevel::CRITICAL: return "CRITICAL";
-        default: return "UNKNOWN";
-    }
-}
-
-bool Logger::shouldLog(LogLevel level) const {
-    return level >= min_level_;
-}
-
-void Logger::writeLog(const std::string& message, LogLevel level) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    std::stringstream log_stream;
-    if (include_timestamp_) log_stream << "[" << getCurrentTimestamp() << "] ";
-    log_stream << "[" << logLevelToString(level) << "] " << message << "\n";
-    
-    if (file_.is_open()) {
-        file_ << log_stream.str();
-        file_.flush();
-    }
-    
-    if (console_output_) {
-        std::cout << log_stream.str();
-        std::cout.flush();
-    }
+#include "Logger.hpp"
+#include "Trace.hpp"
+#include <iostream>
+#include <ctime>
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <thread>
+
+namespace {
+    constexpr size_t RECORD_TEXT_SIZE = 232;
+    constexpr size_t BATCH_BYTES = size_t(256) << 10;
+    constexpr std::chrono::milliseconds IDLE_WAIT(50);
+
+    int64_t currentTimeMicros() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count();
+    }
+
+    size_t roundUpToPowerOfTwo(size_t value) {
+        size_t result = 2;
+        while (result < value) result <<= 1;
+        return result;
+    }
+}
+
+// Bounded MPSC queue of fixed-size records (Vyukov's sequence-numbered ring). Producers claim a
+// slot with one CAS and publish it with a release store; the writer thread is the only consumer,
+// so it needs no atomics beyond reading the slot sequence.
+class Logger::AsyncWriter {
+public:
+    AsyncWriter(Logger& owner, const AsyncLogOptions& options)
+        : owner_(owner),
+        options_(options),
+        mask_(roundUpToPowerOfTwo(options.capacity) - 1),
+        cells_(new Cell[mask_ + 1]),
+        enqueue_pos_(0),
+        dequeue_pos_(0),
+        dropped_(0),
+        reported_dropped_(0),
+        stop_(false),
+        wake_requested_(false),
+        flush_target_(0),
+        flushed_pos_(0) {
+        for (size_t i = 0; i <= mask_; ++i) cells_[i].sequence.store(i, std::memory_order_relaxed);
+        thread_ = std::thread([this] { run(); });
+    }
+
+    ~AsyncWriter() {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            stop_ = true;
+        }
+        wake_.notify_one();
+        thread_.join();
+    }
+
+    const AsyncLogOptions& options() const {
+        return options_;
+    }
+
+    uint64_t dropped() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    void push(LogLevel level, const std::string& message) {
+        int64_t time_us = currentTimeMicros();
+        if (tryPush(time_us, level, message)) return;
+        if (options_.overflow != LogOverflowPolicy::BLOCK) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        wakeWriter();
+        while (!tryPush(time_us, level, message)) std::this_thread::yield();
+    }
+
+    void flush() {
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        size_t target = enqueue_pos_.load(std::memory_order_acquire);
+        if (target > flush_target_) flush_target_ = target;
+        wake_.notify_one();
+        flushed_.wait(lock, [&] { return flushed_pos_ >= target || stop_; });
+    }
+
+private:
+    struct Record {
+        int64_t time_us;
+        LogLevel level;
+        uint16_t length;
+        bool truncated;
+        char text[RECORD_TEXT_SIZE];
+    };
+
+    struct alignas(64) Cell {
+        std::atomic<size_t> sequence;
+        Record record;
+    };
+    static_assert(sizeof(Cell) == 256, "Log records should stay four cache lines");
+
+    Logger& owner_;
+    AsyncLogOptions options_;
+    size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<size_t> enqueue_pos_;
+    alignas(64) std::atomic<size_t> dequeue_pos_;
+    std::atomic<uint64_t> dropped_;
+    uint64_t reported_dropped_;
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    std::condition_variable flushed_;
+    bool stop_;
+    bool wake_requested_;
+    size_t flush_target_;
+    size_t flushed_pos_;
+    std::thread thread_;
+
+    bool tryPush(int64_t time_us, LogLevel level, const std::string& message) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        Record& record = cell->record;
+        size_t length = std::min(message.size(), RECORD_TEXT_SIZE);
+        record.time_us = time_us;
+        record.level = level;
+        record.length = static_cast<uint16_t>(length);
+        record.truncated = length < message.size();
+        std::memcpy(record.text, message.data(), length);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+
+        // The writer polls while idle; only wake it early once the queue is half full.
+        if (pos - dequeue_pos_.load(std::memory_order_relaxed) == (mask_ + 1) / 2) wakeWriter();
+        return true;
+    }
+
+    void wakeWriter() {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            wake_requested_ = true;
+        }
+        wake_.notify_one();
+    }
+
+    size_t drain(std::string& batch) {
+        size_t count = 0;
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        while (count <= mask_ && batch.size() < BATCH_BYTES) {
+            Cell& cell = cells_[pos & mask_];
+            if (cell.sequence.load(std::memory_order_acquire) != pos + 1) break;
+
+            const Record& record = cell.record;
+            owner_.appendRecord(batch, record.time_us, record.level, record.text, record.length);
+            if (record.truncated) batch.insert(batch.size() - 1, "...");
+            cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+            ++pos;
+            ++count;
+        }
+        dequeue_pos_.store(pos, std::memory_order_relaxed);
+        return count;
+    }
+
+    void reportDropped(std::string& batch) {
+        if (options_.overflow != LogOverflowPolicy::COUNT) return;
+        uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+        if (dropped == reported_dropped_) return;
+        std::string message = std::to_string(dropped - reported_dropped_) + " log messages dropped (queue full)";
+        owner_.appendRecord(batch, currentTimeMicros(), LogLevel::WARNING, message.data(), message.size());
+        reported_dropped_ = dropped;
+    }
+
+    void run() {
+        std::string batch;
+        batch.reserve(BATCH_BYTES + 512);
+        auto last_flush = std::chrono::steady_clock::now();
+        auto idle_wait = options_.flush_interval.count() > 0 ? std::min(IDLE_WAIT, options_.flush_interval) : IDLE_WAIT;
+        bool dirty = false;
+
+        while (true) {
+            size_t count = drain(batch);
+            reportDropped(batch);
+            if (!batch.empty()) {
+                owner_.writeOutput(batch, false);
+                batch.clear();
+                dirty = true;
+            }
+
+            size_t position = dequeue_pos_.load(std::memory_order_relaxed);
+            auto now = std::chrono::steady_clock::now();
+            bool stopping;
+            bool flush_requested;
+            {
+                std::lock_guard<std::mutex> lock(wake_mutex_);
+                stopping = stop_ && count == 0;
+                flush_requested = flush_target_ > flushed_pos_ && position >= flush_target_;
+            }
+            if (flush_requested || stopping || (dirty && now - last_flush >= options_.flush_interval)) {
+                if (dirty) owner_.file_.flush();
+                dirty = false;
+                last_flush = now;
+                {
+                    std::lock_guard<std::mutex> lock(wake_mutex_);
+                    flushed_pos_ = position;
+                }
+                flushed_.notify_all();
+            }
+            if (stopping) break;
+
+            if (count == 0) {
+                std::unique_lock<std::mutex> lock(wake_mutex_);
+                wake_.wait_for(lock, idle_wait, [this] { return stop_ || wake_requested_ || flush_target_ > flushed_pos_; });
+                wake_requested_ = false;
+            }
+        }
+    }
+};
+
+Logger::Logger(const std::string& filename)
+    : filename_(filename),
+    min_level_(LogLevel::INFO),
+    include_timestamp_(true),
+    console_output_(false),
+    cached_second_(-1) {
+    file_.open(filename, std::ios::app);
+    if (!file_.is_open()) throw std::runtime_error("Failed to open log file: " + filename);
+}
+
+Logger::Logger(const std::string& filename, const AsyncLogOptions& async)
+    : Logger(filename) {
+    if (async.capacity == 0) throw std::invalid_argument("Log queue capacity must be positive");
+    async_ = std::make_unique<AsyncWriter>(*this, async);
+}
+
+Logger::~Logger() {
+    async_.reset();
+    if (file_.is_open()) file_.close();
+}
+
+// The writer thread refers to the logger it belongs to, so moves drain and stop it first and
+// start a new one on the destination.
+Logger::Logger(Logger&& other) noexcept
+    : filename_(std::move(other.filename_)),
+    min_level_(other.min_level_.load()),
+    include_timestamp_(other.include_timestamp_.load()),
+    console_output_(other.console_output_.load()),
+    cached_second_(-1) {
+    std::unique_ptr<AsyncLogOptions> async;
+    if (other.async_) async = std::make_unique<AsyncLogOptions>(other.async_->options());
+    other.async_.reset();
+    file_ = std::move(other.file_);
+    if (async) async_ = std::make_unique<AsyncWriter>(*this, *async);
+}
+
+Logger& Logger::operator=(Logger&& other) noexcept {
+    if (this != &other) {
+        async_.reset();
+        if (file_.is_open()) file_.close();
+        std::unique_ptr<AsyncLogOptions> async;
+        if (other.async_) async = std::make_unique<AsyncLogOptions>(other.async_->options());
+        other.async_.reset();
+        filename_ = std::move(other.filename_);
+        file_ = std::move(other.file_);
+        min_level_ = other.min_level_.load();
+        include_timestamp_ = other.include_timestamp_.load();
+        console_output_ = other.console_output_.load();
+        cached_second_ = -1;
+        if (async) async_ = std::make_unique<AsyncWriter>(*this, *async);
+    }
+    return *this;
+}
+
+void Logger::log(const std::string& message, LogLevel level) {
+    if (!shouldLog(level)) return;
+    Trace::Span span("Logger::log");
+    if (async_) async_->push(level, message);
+    else writeLog(message, level);
+}
+
+void Logger::debug(const std::string& message) {
+    log(message, LogLevel::DEBUG);
+}
+
+void Logger::info(const std::string& message) {
+    log(message, LogLevel::INFO);
+}
+
+void Logger::warning(const std::string& message) {
+    log(message, LogLevel::WARNING);
+}
+
+void Logger::error(const std::string& message) {
+    log(message, LogLevel::ERROR);
+}
+
+void Logger::critical(const std::string& message) {
+    log(message, LogLevel::CRITICAL);
+}
+
+void Logger::setLogLevel(LogLevel level) {
+    min_level_ = level;
+}
+
+LogLevel Logger::getLogLevel() const {
+    return min_level_;
+}
+
+void Logger::enableTimestamp(bool enable) {
+    include_timestamp_ = enable;
+}
+
+void Logger::enableConsoleOutput(bool enable) {
+    console_output_ = enable;
+}
+
+void Logger::flush() {
+    if (async_) {
+        async_->flush();
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_.flush();
+}
+
+bool Logger::isAsync() const {
+    return async_ != nullptr;
+}
+
+uint64_t Logger::getDroppedCount() const {
+    return async_ ? async_->dropped() : 0;
+}
+
+// Formats one line. Only one thread formats at a time (the caller under mutex_ in sync mode, the
+// writer thread in async mode), so the per-second timestamp cache needs no locking of its own.
+void Logger::appendRecord(std::string& out, int64_t time_us, LogLevel level, const char* message, size_t length) {
+    if (include_timestamp_) {
+        int64_t second = time_us / 1000000;
+        if (second != cached_second_) {
+            std::time_t time = static_cast<std::time_t>(second);
+            std::tm local_time;
+#ifdef _WIN32
+            localtime_s(&local_time, &time);
+#else
+            localtime_r(&time, &local_time);
+#endif
+            char text[32];
+            size_t size = std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &local_time);
+            cached_time_.assign(text, size);
+            cached_second_ = second;
+        }
+        int ms = static_cast<int>(time_us / 1000 % 1000);
+        char millis[5] = { '.', static_cast<char>('0' + ms / 100), static_cast<char>('0' + ms / 10 % 10),
+                           static_cast<char>('0' + ms % 10), ']' };
+        out += '[';
+        out += cached_time_;
+        out.append(millis, sizeof(millis));
+        out += ' ';
+    }
+    out += '[';
+    out += logLevelToString(level);
+    out += "] ";
+    out.append(message, length);
+    out += '\n';
+}
+
+const char* Logger::logLevelToString(LogLevel level) const {
+    switch (level) {
+        case LogLevel::DEBUG: return "DEBUG";
+        case LogLevel::INFO: return "INFO";
+        case LogLevel::WARNING: return "WARNING";
+        case LogLevel::ERROR: return "ERROR";
+        case LogLevel::CRITICAL: return "CRITICAL";
+        default: return "UNKNOWN";
+    }
+}
+
+bool Logger::shouldLog(LogLevel level) const {
+    return level >= min_level_.load(std::memory_order_relaxed);
+}
+
+void Logger::writeLog(const std::string& message, LogLevel level) {
+    int64_t time_us = currentTimeMicros();
+    std::lock_guard<std::mutex> lock(mutex_);
+    line_buffer_.clear();
+    appendRecord(line_buffer_, time_us, level, message.data(), message.size());
+    writeOutput(line_buffer_, true);
+}
+
+void Logger::writeOutput(const std::string& text, bool flush_file) {
+    Trace::Span span("Logger::writeOutput");
+    if (file_.is_open()) {
+        file_.write(text.data(), static_cast<std::streamsize>(text.size()));
+        if (flush_file) file_.flush();
+    }
+
+    if (console_output_) {
+        std::cout << text;
+        std::cout.flush();
+    }
 }
\ No newline at end of file
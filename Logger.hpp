@@ -0,0 +1,85 @@
+#ifndef LOGGER_HPP
+#define LOGGER_HPP
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+enum class LogLevel {
+    DEBUG,
+    INFO,
+    WARNING,
+    ERROR,
+    CRITICAL
+};
+
+// What an asynchronous logger does when its queue is full.
+enum class LogOverflowPolicy {
+    BLOCK,  // wait for the writer thread to make room
+    DROP,   // discard the message
+    COUNT   // discard the message and log how many were lost once there is room again
+};
+
+struct AsyncLogOptions {
+    size_t capacity = 8192;  // queued messages, rounded up to a power of two
+    LogOverflowPolicy overflow = LogOverflowPolicy::BLOCK;
+    // Longest time a written message may sit in the stream buffer; zero flushes after every batch.
+    std::chrono::milliseconds flush_interval = std::chrono::milliseconds(1000);
+};
+
+class Logger {
+public:
+    explicit Logger(const std::string& filename);
+    // Messages are queued without locking and written in batches by a background thread. Messages
+    // longer than a queue record are truncated.
+    Logger(const std::string& filename, const AsyncLogOptions& async);
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+    Logger(Logger&& other) noexcept;
+    Logger& operator=(Logger&& other) noexcept;
+
+    void log(const std::string& message, LogLevel level = LogLevel::INFO);
+    void debug(const std::string& message);
+    void info(const std::string& message);
+    void warning(const std::string& message);
+    void error(const std::string& message);
+    void critical(const std::string& message);
+
+    void setLogLevel(LogLevel level);
+    LogLevel getLogLevel() const;
+    void enableTimestamp(bool enable);
+    void enableConsoleOutput(bool enable);
+    // In async mode, waits until every message logged before the call has reached the file.
+    void flush();
+
+    bool isAsync() const;
+    uint64_t getDroppedCount() const;
+
+private:
+    class AsyncWriter;
+
+    std::string filename_;
+    std::ofstream file_;
+    std::atomic<LogLevel> min_level_;
+    std::atomic<bool> include_timestamp_;
+    std::atomic<bool> console_output_;
+    std::mutex mutex_;
+    std::string line_buffer_;
+    int64_t cached_second_;
+    std::string cached_time_;
+    std::unique_ptr<AsyncWriter> async_;
+
+    void appendRecord(std::string& out, int64_t time_us, LogLevel level, const char* message, size_t length);
+    const char* logLevelToString(LogLevel level) const;
+    bool shouldLog(LogLevel level) const;
+    void writeLog(const std::string& message, LogLevel level);
+    void writeOutput(const std::string& text, bool flush_file);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "MappedFile.hpp"
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+    : data_(nullptr),
+    size_(0)
+#ifdef _WIN32
+    , file_handle_(nullptr),
+    mapping_handle_(nullptr)
+#endif
+{
+}
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& filename, MappedFileAccess access) : MappedFile() {
+    DWORD flags = FILE_ATTRIBUTE_NORMAL;
+    if (access == MappedFileAccess::RANDOM) flags |= FILE_FLAG_RANDOM_ACCESS;
+    else if (access == MappedFileAccess::SEQUENTIAL) flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+    if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("Failed to open file: " + filename);
+    file_handle_ = file;
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        close();
+        throw std::runtime_error("Failed to read size of file: " + filename);
+    }
+    size_ = static_cast<size_t>(file_size.QuadPart);
+    if (size_ == 0) return;
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        close();
+        throw std::runtime_error("Failed to map file: " + filename);
+    }
+    mapping_handle_ = mapping;
+
+    data_ = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (data_ == nullptr) {
+        close();
+        throw std::runtime_error("Failed to map file: " + filename);
+    }
+}
+#else
+MappedFile::MappedFile(const std::string& filename, MappedFileAccess access) : MappedFile() {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Failed to open file: " + filename);
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to read size of file: " + filename);
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    if (size_ == 0) {
+        ::close(fd);
+        return;
+    }
+
+    void* address = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        size_ = 0;
+        throw std::runtime_error("Failed to map file: " + filename);
+    }
+    data_ = static_cast<const unsigned char*>(address);
+
+    if (access == MappedFileAccess::RANDOM) ::madvise(address, size_, MADV_RANDOM);
+    else if (access == MappedFileAccess::SEQUENTIAL) ::madvise(address, size_, MADV_SEQUENTIAL);
+}
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept : MappedFile() {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+#ifdef _WIN32
+        std::swap(file_handle_, other.file_handle_);
+        std::swap(mapping_handle_, other.mapping_handle_);
+#endif
+    }
+    return *this;
+}
+
+bool MappedFile::isOpen() const {
+    return data_ != nullptr;
+}
+
+const unsigned char* MappedFile::data() const {
+    return data_;
+}
+
+size_t MappedFile::size() const {
+    return size_;
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_handle_) CloseHandle(mapping_handle_);
+    if (file_handle_) CloseHandle(file_handle_);
+    mapping_handle_ = nullptr;
+    file_handle_ = nullptr;
+#else
+    if (data_) ::munmap(const_cast<unsigned char*>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+#include <cstddef>
+#include <string>
+
+enum class MappedFileAccess {
+    NORMAL,
+    RANDOM,
+    SEQUENTIAL
+};
+
+// Read-only memory mapping of a whole file. Pages are faulted in by the OS on first access.
+class MappedFile {
+public:
+    MappedFile();
+    explicit MappedFile(const std::string& filename, MappedFileAccess access = MappedFileAccess::NORMAL);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool isOpen() const;
+    const unsigned char* data() const;
+    size_t size() const;
+
+private:
+    const unsigned char* data_;
+    size_t size_;
+#ifdef _WIN32
+    void* file_handle_;
+    void* mapping_handle_;
+#endif
+
+    void close();
+};
+
+#endif
\ No newline at end of file
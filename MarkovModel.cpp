@@ -0,0 +1,192 @@
+#include "MarkovModel.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+    const char MODEL_MAGIC[8] = { 'P', 'W', 'M', 'A', 'R', 'K', 'V', '1' };
+    constexpr uint32_t MODEL_VERSION = 1;
+    constexpr uint32_t MODEL_ORDER = 3;
+    constexpr unsigned ALPHABET = MarkovModel::ALPHABET_SIZE;
+    constexpr size_t TABLE_SIZE = size_t(ALPHABET) * ALPHABET * ALPHABET;
+    // Start of a password as context, end of it as the next symbol.
+    constexpr uint8_t BOUNDARY = 0;
+    constexpr uint8_t OTHER = 0xFF;
+    constexpr uint32_t OTHER_COST = 8 * MarkovModel::COST_SCALE;
+    // Weight of the lower-order estimate that each order backs off to, in pseudo-counts.
+    constexpr double SMOOTHING = 1.0;
+
+    struct ModelHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t order;
+        uint32_t alphabet_size;
+        uint32_t cost_scale;
+        uint64_t training_count;
+        uint64_t table_size;
+        uint8_t reserved[24];
+    };
+    static_assert(sizeof(ModelHeader) == 64, "Markov model header must stay 64 bytes");
+
+    constexpr std::array<uint8_t, 256> makeSymbols() {
+        std::array<uint8_t, 256> symbols{};
+        for (int c = 0; c < 256; ++c) {
+            symbols[c] = c >= 0x20 && c <= 0x7E ? static_cast<uint8_t>(c - 0x1F) : OTHER;
+        }
+        return symbols;
+    }
+
+    constexpr std::array<uint8_t, 256> SYMBOLS = makeSymbols();
+
+    bool parseCountedLine(const std::string& line, uint64_t& count, std::string_view& password) {
+        size_t i = 0;
+        while (i < line.size() && (line[i] == ' ' || line[i] == '\t')) ++i;
+        size_t digits = i;
+        count = 0;
+        while (i < line.size() && line[i] >= '0' && line[i] <= '9') count = count * 10 + static_cast<uint64_t>(line[i++] - '0');
+        if (i == digits || i >= line.size() || (line[i] != ' ' && line[i] != '\t')) return false;
+        password = std::string_view(line).substr(i + 1);
+        return true;
+    }
+}
+
+MarkovModel::MarkovModel(const std::string& filename)
+    : file_(filename, MappedFileAccess::RANDOM) {
+    if (file_.size() < sizeof(ModelHeader)) throw std::runtime_error("Invalid Markov model: " + filename);
+
+    ModelHeader header;
+    std::memcpy(&header, file_.data(), sizeof(header));
+    if (std::memcmp(header.magic, MODEL_MAGIC, sizeof(MODEL_MAGIC)) != 0 || header.version != MODEL_VERSION ||
+        header.order != MODEL_ORDER || header.alphabet_size != ALPHABET || header.cost_scale != COST_SCALE) {
+        throw std::runtime_error("Unsupported Markov model format: " + filename);
+    }
+    if (header.table_size != TABLE_SIZE || file_.size() != sizeof(ModelHeader) + TABLE_SIZE) {
+        throw std::runtime_error("Corrupt Markov model: " + filename);
+    }
+
+    training_count_ = header.training_count;
+    costs_ = file_.data() + sizeof(ModelHeader);
+}
+
+uint64_t MarkovModel::getTrainingCount() const {
+    return training_count_;
+}
+
+size_t MarkovModel::getSizeBytes() const {
+    return file_.size();
+}
+
+double MarkovModel::cost(std::string_view password) const {
+    return static_cast<double>(quantizedCost(password)) / COST_SCALE;
+}
+
+uint32_t MarkovModel::quantizedCost(std::string_view password) const {
+    uint32_t total = 0;
+    unsigned previous = BOUNDARY;
+    unsigned context = BOUNDARY;
+    for (char ch : password) {
+        unsigned symbol = SYMBOLS[static_cast<unsigned char>(ch)];
+        if (symbol == OTHER) {
+            total += OTHER_COST;
+            previous = context = BOUNDARY;
+            continue;
+        }
+        total += costs_[context * ALPHABET + symbol];
+        context = previous * ALPHABET + symbol;
+        previous = symbol;
+    }
+    return total + costs_[context * ALPHABET + BOUNDARY];
+}
+
+uint64_t MarkovModel::train(std::istream& input, const std::string& output_file, bool counted) {
+    std::vector<uint64_t> trigrams(TABLE_SIZE, 0);
+    uint64_t passwords = 0;
+    std::string line;
+    while (std::getline(input, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        uint64_t count = 1;
+        std::string_view password = line;
+        if (counted && !parseCountedLine(line, count, password)) continue;
+        if (password.empty() || count == 0) continue;
+
+        size_t previous = BOUNDARY;
+        size_t context = BOUNDARY;
+        for (char ch : password) {
+            size_t symbol = SYMBOLS[static_cast<unsigned char>(ch)];
+            if (symbol == OTHER) {
+                previous = context = BOUNDARY;
+                continue;
+            }
+            trigrams[context * ALPHABET + symbol] += count;
+            context = previous * ALPHABET + symbol;
+            previous = symbol;
+        }
+        trigrams[context * ALPHABET + BOUNDARY] += count;
+        passwords += count;
+    }
+    if (passwords == 0) throw std::runtime_error("No passwords to train the Markov model on");
+
+    // Each order is smoothed towards the one below it: the trigram estimate towards the bigram
+    // estimate for the same previous character, that one towards the unigram estimate, and that
+    // one towards uniform, so steps never seen in training still get a finite cost.
+    std::vector<uint64_t> bigrams(size_t(ALPHABET) * ALPHABET, 0);
+    std::vector<uint64_t> unigrams(ALPHABET, 0);
+    for (size_t first = 0; first < ALPHABET; ++first) {
+        for (size_t second = 0; second < ALPHABET; ++second) {
+            for (size_t next = 0; next < ALPHABET; ++next) {
+                uint64_t count = trigrams[(first * ALPHABET + second) * ALPHABET + next];
+                bigrams[second * ALPHABET + next] += count;
+                unigrams[next] += count;
+            }
+        }
+    }
+    uint64_t unigram_total = 0;
+    for (uint64_t count : unigrams) unigram_total += count;
+
+    std::vector<double> unigram_p(ALPHABET);
+    for (size_t next = 0; next < ALPHABET; ++next) {
+        unigram_p[next] = (static_cast<double>(unigrams[next]) + 1.0) / (static_cast<double>(unigram_total) + ALPHABET);
+    }
+    std::vector<double> bigram_p(size_t(ALPHABET) * ALPHABET);
+    for (size_t second = 0; second < ALPHABET; ++second) {
+        const uint64_t* row = bigrams.data() + second * ALPHABET;
+        double total = 0.0;
+        for (size_t next = 0; next < ALPHABET; ++next) total += static_cast<double>(row[next]);
+        for (size_t next = 0; next < ALPHABET; ++next) {
+            bigram_p[second * ALPHABET + next] = (static_cast<double>(row[next]) + SMOOTHING * unigram_p[next]) / (total + SMOOTHING);
+        }
+    }
+
+    std::vector<uint8_t> costs(TABLE_SIZE);
+    for (size_t context = 0; context < size_t(ALPHABET) * ALPHABET; ++context) {
+        const uint64_t* row = trigrams.data() + context * ALPHABET;
+        const double* backoff = bigram_p.data() + (context % ALPHABET) * ALPHABET;
+        double total = 0.0;
+        for (size_t next = 0; next < ALPHABET; ++next) total += static_cast<double>(row[next]);
+        for (size_t next = 0; next < ALPHABET; ++next) {
+            double p = (static_cast<double>(row[next]) + SMOOTHING * backoff[next]) / (total + SMOOTHING);
+            double cost = std::round(-std::log2(p) * COST_SCALE);
+            costs[context * ALPHABET + next] = static_cast<uint8_t>(std::min(cost, 255.0));
+        }
+    }
+
+    ModelHeader header = {};
+    std::memcpy(header.magic, MODEL_MAGIC, sizeof(MODEL_MAGIC));
+    header.version = MODEL_VERSION;
+    header.order = MODEL_ORDER;
+    header.alphabet_size = ALPHABET;
+    header.cost_scale = COST_SCALE;
+    header.training_count = passwords;
+    header.table_size = TABLE_SIZE;
+
+    std::ofstream out(output_file, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) throw std::runtime_error("Failed to create Markov model: " + output_file);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(costs.data()), static_cast<std::streamsize>(costs.size()));
+    if (!out) throw std::runtime_error("Failed to write Markov model: " + output_file);
+    return passwords;
+}
\ No newline at end of file
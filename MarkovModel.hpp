@@ -0,0 +1,44 @@
+#ifndef MARKOV_MODEL_HPP
+#define MARKOV_MODEL_HPP
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <string_view>
+#include "MappedFile.hpp"
+
+// Character 3-gram model of how people write passwords, trained on a corpus of real ones. The cost
+// of a password is -log2 of its probability under the model: a password people pick often costs
+// few bits, a random one about log2(95) bits per character.
+//
+// The file holds one byte for every (two previous characters, next character) triple: the cost of
+// that step in 1/COST_SCALE bits. The table is 864 KB and is mapped, not loaded, so bulk scoring
+// keeps it in cache and a password costs one load and one add per character.
+class MarkovModel {
+public:
+    // Printable ASCII plus one symbol that stands for the start and the end of a password.
+    static constexpr unsigned ALPHABET_SIZE = 96;
+    static constexpr unsigned COST_SCALE = 8;
+
+    explicit MarkovModel(const std::string& filename);
+
+    uint64_t getTrainingCount() const;
+    size_t getSizeBytes() const;
+
+    // In bits. A byte outside printable ASCII costs 8 bits and starts a new context.
+    double cost(std::string_view password) const;
+    // In 1/COST_SCALE bits.
+    uint32_t quantizedCost(std::string_view password) const;
+
+    // Trains on input, one password per line, and writes the model to output_file. With counted,
+    // each line is a count followed by whitespace and the password, as `uniq -c` prints them.
+    // Returns the number of passwords trained on, counts included.
+    static uint64_t train(std::istream& input, const std::string& output_file, bool counted);
+
+private:
+    MappedFile file_;
+    uint64_t training_count_;
+    const uint8_t* costs_;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "MarkovModel.hpp"
+
+namespace {
+    void printUsage(const char* program) {
+        std::cerr << "Usage: " << program << " [--counted] <input|-> <output>\n"
+                  << "  Trains a character 3-gram model on a password corpus, one password per line,\n"
+                  << "  and writes it for markov_model= in the configuration. With --counted each line\n"
+                  << "  is \"COUNT PASSWORD\", as printed by sort | uniq -c.\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    bool counted = false;
+    std::string input_path;
+    std::string output_path;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--counted") counted = true;
+        else if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        else if (input_path.empty()) input_path = arg;
+        else if (output_path.empty()) output_path = arg;
+        else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (input_path.empty() || output_path.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+        uint64_t passwords = 0;
+        if (input_path == "-") {
+            passwords = MarkovModel::train(std::cin, output_path, counted);
+        } else {
+            std::ifstream input(input_path, std::ios::binary);
+            if (!input.is_open()) {
+                std::cerr << "Error: cannot open " << input_path << "\n";
+                return 1;
+            }
+            passwords = MarkovModel::train(input, output_path, counted);
+        }
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Trained on " << passwords << " passwords, wrote " << output_path << " in " << elapsed << " s\n";
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,227 @@
+#include "Metrics.hpp"
+#include "ConfigManager.hpp"
+#include "PasswordPolicy.hpp"
+#include "ResultCache.hpp"
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<Metrics::ThreadBlock>> blocks;
+        std::vector<Metrics::ThreadBlock*> free_blocks;
+    };
+
+    // Never destroyed, so threads that outlive static destruction can still give their block back.
+    Registry& registry() {
+        static Registry* instance = new Registry();
+        return *instance;
+    }
+
+    // Returns the thread's block to the free list when the thread exits. The counts stay in the
+    // block and the next thread to take it keeps adding to them.
+    struct BlockOwner {
+        Metrics::ThreadBlock* block = nullptr;
+
+        ~BlockOwner() {
+            if (block == nullptr) return;
+            Metrics::current_block = nullptr;
+            Registry& shared = registry();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            shared.free_blocks.push_back(block);
+        }
+    };
+
+    thread_local BlockOwner block_owner;
+
+    // 1-2-5 steps from 100 ns to 10 s.
+    constexpr double BUCKET_BOUNDS[] = {
+        1e-7, 2e-7, 5e-7, 1e-6, 2e-6, 5e-6, 1e-5, 2e-5, 5e-5, 1e-4, 2e-4, 5e-4,
+        1e-3, 2e-3, 5e-3, 1e-2, 2e-2, 5e-2, 1e-1, 2e-1, 5e-1, 1.0, 2.0, 5.0, 10.0
+    };
+
+    struct HistogramInfo {
+        const char* name;
+        const char* help;
+    };
+
+    constexpr HistogramInfo HISTOGRAMS[Metrics::HISTOGRAM_COUNT] = {
+        { "password_checker_analyze_duration_seconds", "Time to compute the features of one password." },
+        { "password_checker_check_duration_seconds", "Time for one check call, details report included." },
+        { "password_checker_batch_duration_seconds", "Time for one checkBatch call." },
+        { "password_checker_request_duration_seconds", "Time for the daemon to answer one request." }
+    };
+
+    constexpr const char* STRENGTH_LABELS[] = { "weak", "medium", "strong", "very_strong" };
+    static_assert(sizeof(STRENGTH_LABELS) / sizeof(STRENGTH_LABELS[0]) == Metrics::RULE_MIN_LENGTH,
+                  "Every strength counter needs a label");
+    // Rule counters follow the PolicyCheck bits and take their labels from PolicyCheck::NAMES.
+    static_assert(PolicyCheck::COUNT == Metrics::COUNTER_COUNT - Metrics::RULE_MIN_LENGTH,
+                  "Every rule counter needs a label");
+
+    std::string formatDouble(double value) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+        return buffer;
+    }
+
+    void appendHeader(std::string& out, const char* name, const char* type, const char* help) {
+        out += "# HELP ";
+        out += name;
+        out += ' ';
+        out += help;
+        out += "\n# TYPE ";
+        out += name;
+        out += ' ';
+        out += type;
+        out += '\n';
+    }
+
+    void appendSample(std::string& out, const char* name, const std::string& labels, const std::string& value) {
+        out += name;
+        if (!labels.empty()) {
+            out += '{';
+            out += labels;
+            out += '}';
+        }
+        out += ' ';
+        out += value;
+        out += '\n';
+    }
+
+    void appendSingle(std::string& out, const char* name, const char* type, const char* help, uint64_t value) {
+        appendHeader(out, name, type, help);
+        appendSample(out, name, "", std::to_string(value));
+    }
+
+    // Exclusive upper bound, in ticks, of the values that land in bucket.
+    double bucketLimit(unsigned bucket) {
+        if (bucket < Metrics::SUB_BUCKETS) return bucket + 1.0;
+        unsigned shift = (bucket >> Metrics::SUB_BUCKET_BITS) - 1;
+        double base = Metrics::SUB_BUCKETS + (bucket & (Metrics::SUB_BUCKETS - 1)) + 1.0;
+        return base * static_cast<double>(uint64_t(1) << shift);
+    }
+}
+
+namespace Metrics {
+    ThreadBlock* acquireBlock() {
+        Registry& shared = registry();
+        ThreadBlock* block;
+        {
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            if (!shared.free_blocks.empty()) {
+                block = shared.free_blocks.back();
+                shared.free_blocks.pop_back();
+            } else {
+                shared.blocks.push_back(std::make_unique<ThreadBlock>());
+                block = shared.blocks.back().get();
+            }
+        }
+        block_owner.block = block;
+        current_block = block;
+        return block;
+    }
+
+    std::string renderPrometheus(const ConfigManager* config, const ResultCache* cache) {
+        std::string out;
+        if constexpr (ENABLED) {
+            std::vector<uint64_t> counters(COUNTER_COUNT, 0);
+            std::vector<uint64_t> buckets(size_t(HISTOGRAM_COUNT) * BUCKET_COUNT, 0);
+            std::vector<uint64_t> sums(HISTOGRAM_COUNT, 0);
+            {
+                Registry& shared = registry();
+                std::lock_guard<std::mutex> lock(shared.mutex);
+                for (const auto& block : shared.blocks) {
+                    for (unsigned c = 0; c < COUNTER_COUNT; ++c) counters[c] += block->counters[c].load(std::memory_order_relaxed);
+                    for (unsigned h = 0; h < HISTOGRAM_COUNT; ++h) {
+                        sums[h] += block->sums[h].load(std::memory_order_relaxed);
+                        for (unsigned b = 0; b < BUCKET_COUNT; ++b) {
+                            buckets[size_t(h) * BUCKET_COUNT + b] += block->buckets[h][b].load(std::memory_order_relaxed);
+                        }
+                    }
+                }
+            }
+
+            appendHeader(out, "password_checker_checks_total", "counter", "Passwords scored, by resulting strength.");
+            for (unsigned c = CHECKS_WEAK; c < RULE_MIN_LENGTH; ++c) {
+                appendSample(out, "password_checker_checks_total",
+                             std::string("strength=\"") + STRENGTH_LABELS[c] + "\"", std::to_string(counters[c]));
+            }
+            appendHeader(out, "password_checker_rule_failures_total", "counter",
+                         "Scored passwords that failed each enabled rule.");
+            for (unsigned c = RULE_MIN_LENGTH; c < COUNTER_COUNT; ++c) {
+                appendSample(out, "password_checker_rule_failures_total",
+                             std::string("rule=\"") + PolicyCheck::NAMES[c - RULE_MIN_LENGTH] + "\"", std::to_string(counters[c]));
+            }
+
+            double seconds_per_tick = TickClock::secondsPerTick();
+            for (unsigned h = 0; h < HISTOGRAM_COUNT; ++h) {
+                const HistogramInfo& info = HISTOGRAMS[h];
+                const uint64_t* counts = buckets.data() + size_t(h) * BUCKET_COUNT;
+                appendHeader(out, info.name, "histogram", info.help);
+
+                // A bucket is counted under a bound once every value it can hold is at or below it.
+                std::string bucket_name = std::string(info.name) + "_bucket";
+                uint64_t cumulative = 0;
+                unsigned next = 0;
+                for (double bound : BUCKET_BOUNDS) {
+                    while (next < BUCKET_COUNT && bucketLimit(next) * seconds_per_tick <= bound) cumulative += counts[next++];
+                    appendSample(out, bucket_name.c_str(), "le=\"" + formatDouble(bound) + "\"", std::to_string(cumulative));
+                }
+                while (next < BUCKET_COUNT) cumulative += counts[next++];
+                appendSample(out, bucket_name.c_str(), "le=\"+Inf\"", std::to_string(cumulative));
+                appendSample(out, (std::string(info.name) + "_sum").c_str(), "",
+                             formatDouble(static_cast<double>(sums[h]) * seconds_per_tick));
+                appendSample(out, (std::string(info.name) + "_count").c_str(), "", std::to_string(cumulative));
+            }
+        }
+
+        if (config) {
+            appendSingle(out, "password_checker_dictionary_words", "gauge", "Distinct words in the common word matcher.",
+                         config->getWordMatcher().getWordCount());
+            if (const BreachCorpus* corpus = config->getBreachCorpus()) {
+                appendSingle(out, "password_checker_breach_corpus_records", "gauge", "Hashes in the breach corpus.",
+                             corpus->getRecordCount());
+            }
+            if (const BreachFilter* filter = config->getBreachFilter()) {
+                appendSingle(out, "password_checker_breach_filter_entries", "gauge", "Hashes in the breach filter.",
+                             filter->getEntryCount());
+            }
+        }
+        if (cache) {
+            ResultCache::Stats stats = cache->getStats();
+            appendSingle(out, "password_checker_cache_hits_total", "counter", "Result cache lookups that hit.", stats.hits);
+            appendSingle(out, "password_checker_cache_misses_total", "counter", "Result cache lookups that missed.", stats.misses);
+            appendSingle(out, "password_checker_cache_evictions_total", "counter", "Result cache entries evicted.", stats.evictions);
+            appendSingle(out, "password_checker_cache_entries", "gauge", "Entries in the result cache.", stats.entries);
+            appendSingle(out, "password_checker_cache_capacity", "gauge", "Result cache capacity in entries.", stats.capacity);
+            appendSingle(out, "password_checker_cache_memory_bytes", "gauge", "Memory held by the result cache.", stats.memory_bytes);
+        }
+        return out;
+    }
+
+    bool writeFile(const std::string& filename, const std::string& text) {
+        std::string temp_file = filename + ".tmp";
+        {
+            std::ofstream out(temp_file, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) return false;
+            out.write(text.data(), static_cast<std::streamsize>(text.size()));
+            if (!out) {
+                out.close();
+                std::remove(temp_file.c_str());
+                return false;
+            }
+        }
+        if (std::rename(temp_file.c_str(), filename.c_str()) != 0) {
+            std::remove(filename.c_str());
+            if (std::rename(temp_file.c_str(), filename.c_str()) != 0) {
+                std::remove(temp_file.c_str());
+                return false;
+            }
+        }
+        return true;
+    }
+}
\ No newline at end of file
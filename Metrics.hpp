@@ -0,0 +1,124 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include "TickClock.hpp"
+
+// Set to 0 (CMake: -DPASSWORD_CHECKER_ENABLE_METRICS=OFF) and every recording call compiles to
+// nothing; rendering then reports only the dictionary and cache gauges.
+#ifndef PASSWORD_CHECKER_METRICS
+#define PASSWORD_CHECKER_METRICS 1
+#endif
+
+class ConfigManager;
+class ResultCache;
+
+// Process-wide counters and latency histograms, exported in the Prometheus text format.
+//
+// Each thread records into a block of its own, so recording is a plain load and store with no
+// locked instruction or shared cache line; rendering sums the blocks. Latencies are kept in raw
+// clock ticks (the TSC on x86-64) and converted to seconds only when rendered.
+namespace Metrics {
+    constexpr bool ENABLED = PASSWORD_CHECKER_METRICS != 0;
+
+    enum Counter : unsigned {
+        CHECKS_WEAK,
+        CHECKS_MEDIUM,
+        CHECKS_STRONG,
+        CHECKS_VERY_STRONG,
+        RULE_MIN_LENGTH,
+        RULE_UPPER,
+        RULE_LOWER,
+        RULE_DIGIT,
+        RULE_SPECIAL,
+        RULE_REPEATS,
+        RULE_SEQUENCE,
+        RULE_COMMON_WORD,
+        RULE_ENTROPY,
+        RULE_BREACHED,
+        COUNTER_COUNT
+    };
+
+    enum Histogram : unsigned {
+        ANALYZE_LATENCY,
+        CHECK_LATENCY,
+        BATCH_LATENCY,
+        REQUEST_LATENCY,
+        HISTOGRAM_COUNT
+    };
+
+    // Log-linear buckets in the style of HdrHistogram: values below 8 ticks get a bucket each and
+    // every power of two above is split into 8, so a bucket's bounds are within 12.5% of each other.
+    constexpr unsigned SUB_BUCKET_BITS = 3;
+    constexpr unsigned SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+    constexpr unsigned BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    struct ThreadBlock {
+        std::atomic<uint64_t> counters[COUNTER_COUNT];
+        std::atomic<uint64_t> buckets[HISTOGRAM_COUNT][BUCKET_COUNT];
+        std::atomic<uint64_t> sums[HISTOGRAM_COUNT];
+    };
+
+    // Hands the calling thread a block that no other live thread writes to.
+    ThreadBlock* acquireBlock();
+    inline thread_local ThreadBlock* current_block = nullptr;
+
+    inline ThreadBlock& block() {
+        ThreadBlock* current = current_block;
+        return current ? *current : *acquireBlock();
+    }
+
+    // Only the owning thread writes a slot, so a relaxed load and store cannot lose updates.
+    inline void bump(std::atomic<uint64_t>& slot, uint64_t amount) {
+        slot.store(slot.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    inline unsigned topBit(uint64_t value) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return static_cast<unsigned>(index);
+#else
+        return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#endif
+    }
+
+    inline unsigned bucketOf(uint64_t ticks) {
+        if (ticks < SUB_BUCKETS) return static_cast<unsigned>(ticks);
+        unsigned shift = topBit(ticks) - SUB_BUCKET_BITS;
+        return ((shift + 1) << SUB_BUCKET_BITS) + static_cast<unsigned>((ticks >> shift) & (SUB_BUCKETS - 1));
+    }
+
+    inline uint64_t now() {
+        if constexpr (ENABLED) return TickClock::now();
+        else return 0;
+    }
+
+    inline uint64_t since(uint64_t start) {
+        uint64_t end = now();
+        // The TSC of another core may lag slightly after a migration.
+        return end > start ? end - start : 0;
+    }
+
+    inline void add(Counter counter, uint64_t amount = 1) {
+        if constexpr (ENABLED) bump(block().counters[counter], amount);
+    }
+
+    inline void record(Histogram histogram, uint64_t ticks) {
+        if constexpr (ENABLED) {
+            ThreadBlock& current = block();
+            bump(current.buckets[histogram][bucketOf(ticks)], 1);
+            bump(current.sums[histogram], ticks);
+        }
+    }
+
+    // Every counter and histogram, plus dictionary and cache gauges for whichever of config and
+    // cache are given.
+    std::string renderPrometheus(const ConfigManager* config = nullptr, const ResultCache* cache = nullptr);
+    // Writes text to filename through a temporary file and a rename, so a collector reading the
+    // file (such as node_exporter's textfile collector) never sees half of it.
+    bool writeFile(const std::string& filename, const std::string& text);
+}
+
+#endif
\ No newline at end of file
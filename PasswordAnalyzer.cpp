@@ -0,0 +1,155 @@
+#include "PasswordAnalyzer.hpp"
+#include "CharClass.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+
+namespace {
+    constexpr uint8_t kSequenceClasses = CharClass::UPPER | CharClass::LOWER | CharClass::DIGIT;
+
+    inline size_t popcount64(uint64_t x) {
+        return std::bitset<64>(x).count();
+    }
+
+    // The distinct non-ASCII code points of one password, in an open-addressing table sized for
+    // at most max_count of them. The table lives on the stack unless the password is long.
+    class CodePointSet {
+    public:
+        explicit CodePointSet(size_t max_count) {
+            size_t capacity = 16;
+            shift_ = 28;
+            while (capacity < max_count * 2) {
+                capacity *= 2;
+                --shift_;
+            }
+            if (capacity <= STACK_SLOTS) {
+                slots_ = stack_slots_;
+            }
+            else {
+                heap_slots_.reset(new uint32_t[capacity]);
+                slots_ = heap_slots_.get();
+            }
+            mask_ = capacity - 1;
+            std::fill_n(slots_, capacity, 0u);
+        }
+
+        // Returns whether code_point was new. Zero marks an empty slot, which no non-ASCII code
+        // point can collide with.
+        bool insert(uint32_t code_point) {
+            size_t slot = (code_point * 0x9E3779B1u) >> shift_;
+            while (slots_[slot] != 0) {
+                if (slots_[slot] == code_point) return false;
+                slot = (slot + 1) & mask_;
+            }
+            slots_[slot] = code_point;
+            return true;
+        }
+
+    private:
+        static constexpr size_t STACK_SLOTS = 256;
+
+        uint32_t stack_slots_[STACK_SLOTS];
+        std::unique_ptr<uint32_t[]> heap_slots_;
+        uint32_t* slots_;
+        size_t mask_;
+        unsigned shift_;
+    };
+
+    PasswordFeatures analyzeCodePoints(std::string_view password) {
+        PasswordFeatures features;
+        uint64_t seen_ascii[2] = { 0, 0 };
+        // A non-ASCII code point takes at least two bytes.
+        CodePointSet seen_wide(password.size() / 2);
+        uint8_t classes = 0;
+
+        const unsigned char* it = reinterpret_cast<const unsigned char*>(password.data());
+        const unsigned char* end = it + password.size();
+        uint32_t prev2 = 0, prev1 = 0;
+        uint8_t prev2_class = 0, prev1_class = 0;
+        while (it < end) {
+            uint32_t code_point = CharClass::decodeUtf8(it);
+            uint8_t cls = CharClass::ofCodePoint(code_point);
+            classes |= cls;
+            if (code_point < 0x80) {
+                uint64_t bit = uint64_t(1) << (code_point & 63);
+                features.unique_chars += (seen_ascii[code_point >> 6] & bit) == 0;
+                seen_ascii[code_point >> 6] |= bit;
+            }
+            else {
+                features.unique_chars += seen_wide.insert(code_point);
+            }
+
+            if (features.length >= 2 && prev1 == prev2 + 1 && code_point == prev2 + 2) {
+                features.has_sequence |= (cls & kSequenceClasses) && prev2_class == cls && prev1_class == cls;
+            }
+
+            prev2 = prev1;
+            prev1 = code_point;
+            prev2_class = prev1_class;
+            prev1_class = cls;
+            ++features.length;
+        }
+
+        features.has_upper = (classes & CharClass::UPPER) != 0;
+        features.has_lower = (classes & CharClass::LOWER) != 0;
+        features.has_digit = (classes & CharClass::DIGIT) != 0;
+        features.has_special = (classes & CharClass::SPECIAL) != 0;
+        features.has_repeats = features.unique_chars != features.length;
+        features.entropy = features.length * std::log2(static_cast<double>(features.unique_chars));
+        return features;
+    }
+}
+
+namespace PasswordAnalyzer {
+    PasswordFeatures analyzeCharacters(std::string_view password, TextEncoding encoding) {
+        Trace::Span span("PasswordAnalyzer::analyzeCharacters");
+        // ASCII, and text that is not UTF-8 at all, reads the same either way.
+        if (encoding == TextEncoding::UTF8 &&
+            CharClass::validateUtf8(password.data(), password.size()) == CharClass::Utf8Status::VALID) {
+            return analyzeCodePoints(password);
+        }
+
+        PasswordFeatures features;
+        features.length = password.length();
+
+        uint64_t seen[4] = { 0, 0, 0, 0 };
+        uint8_t classes = CharClass::classify(password.data(), password.size());
+
+        // Three consecutive code points are rare, so their classes are only looked up on a hit.
+        unsigned char prev2 = 0, prev1 = 0;
+        for (size_t i = 0; i < password.length(); ++i) {
+            unsigned char c = static_cast<unsigned char>(password[i]);
+            seen[c >> 6] |= uint64_t(1) << (c & 63);
+
+            if (i >= 2 && prev1 == prev2 + 1 && c == prev2 + 2 && !features.has_sequence) {
+                uint8_t cls = CharClass::of(c);
+                features.has_sequence = (cls & kSequenceClasses) && CharClass::of(prev2) == cls && CharClass::of(prev1) == cls;
+            }
+
+            prev2 = prev1;
+            prev1 = c;
+        }
+
+        features.has_upper = (classes & CharClass::UPPER) != 0;
+        features.has_lower = (classes & CharClass::LOWER) != 0;
+        features.has_digit = (classes & CharClass::DIGIT) != 0;
+        features.has_special = (classes & CharClass::SPECIAL) != 0;
+
+        features.unique_chars = popcount64(seen[0]) + popcount64(seen[1]) + popcount64(seen[2]) + popcount64(seen[3]);
+        features.has_repeats = features.unique_chars != features.length;
+        if (features.length > 0) {
+            features.entropy = features.length * std::log2(static_cast<double>(features.unique_chars));
+        }
+
+        return features;
+    }
+
+    PasswordFeatures analyze(std::string_view password, const WordMatcher& commonWords, TextEncoding encoding) {
+        PasswordFeatures features = analyzeCharacters(password, encoding);
+        features.has_common_word = commonWords.containsAny(password);
+        return features;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#ifndef PASSWORD_ANALYZER_HPP
+#define PASSWORD_ANALYZER_HPP
+#include <cstddef>
+#include <string_view>
+#include "CharClass.hpp"
+#include "WordMatcher.hpp"
+
+struct PasswordFeatures {
+    size_t length = 0;
+    size_t unique_chars = 0;
+    bool has_upper = false;
+    bool has_lower = false;
+    bool has_digit = false;
+    bool has_special = false;
+    bool has_repeats = false;
+    bool has_sequence = false;
+    bool has_common_word = false;
+    bool meets_min_length = false;
+    bool is_breached = false;
+    double entropy = 0.0;
+    // Only computed when the policy scores by estimated guesses (see GuessEstimator.hpp).
+    double guesses_log10 = 0.0;
+    // Only computed when the configuration has a Markov model (see MarkovModel.hpp).
+    double markov_bits = 0.0;
+};
+
+namespace PasswordAnalyzer {
+    // Computes every character-level feature in a single pass over the password. The word match
+    // and the fields that depend on configuration are left at their defaults. With UTF8, text that
+    // is valid UTF-8 and not pure ASCII is measured in code points: length, unique characters,
+    // entropy, repeats and sequences count code points and classes come from CharClass::ofCodePoint.
+    PasswordFeatures analyzeCharacters(std::string_view password, TextEncoding encoding = TextEncoding::BYTES);
+    // analyzeCharacters plus the common-word match.
+    PasswordFeatures analyze(std::string_view password, const WordMatcher& commonWords,
+                             TextEncoding encoding = TextEncoding::BYTES);
+}
+
+#endif
\ No newline at end of file
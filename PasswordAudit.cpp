@@ -0,0 +1,654 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ConfigManager.hpp"
+#include "MappedFile.hpp"
+#include "Metrics.hpp"
+#include "PasswordChecker.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+namespace {
+    constexpr size_t BLOCK_LINES = 1 << 16;
+    constexpr size_t READ_CHUNK = size_t(4) << 20;
+    constexpr size_t OUTPUT_FLUSH = size_t(1) << 20;
+
+    enum class OutputFormat {
+        CSV,
+        JSONL
+    };
+
+    struct AuditOptions {
+        std::string config_path;
+        std::string input_path;
+        std::string output_path;
+        std::string metrics_path;
+        std::string trace_path;
+        OutputFormat format = OutputFormat::CSV;
+        bool include_password = false;
+        bool include_guesses = false;
+        bool include_markov = false;
+        bool stats = false;
+        size_t threads = 1;
+    };
+
+    struct LineView {
+        const char* data;
+        size_t size;
+        uint64_t number;
+    };
+
+    struct ScoredLine {
+        PasswordStrength strength;
+        PasswordFeatures features;
+    };
+
+    constexpr size_t STATS_GRAIN = 4096;
+    constexpr size_t STATS_SLOTS = (BLOCK_LINES + STATS_GRAIN - 1) / STATS_GRAIN;
+    // Lengths 0..31 get a bucket each; the last bucket holds everything longer.
+    constexpr size_t LENGTH_BUCKETS = 33;
+    constexpr size_t ENTROPY_BUCKET_BITS = 10;
+    constexpr size_t ENTROPY_BUCKETS = 16;
+
+    // Totals for one slice of the input. Every chunk of a block has its own accumulator on its own
+    // cache lines, so scoring threads never write to shared memory; the slots are summed once the
+    // whole input is done.
+    struct alignas(64) StatsAccumulator {
+        uint64_t passwords = 0;
+        uint64_t bytes = 0;
+        uint64_t length_sum = 0;
+        double entropy_sum = 0.0;
+        double guesses_log10_sum = 0.0;
+        double markov_bits_sum = 0.0;
+        uint64_t strengths[4] = {};
+        // Indexed by PolicyCheck bit.
+        uint64_t rule_failures[PolicyCheck::COUNT] = {};
+        uint64_t lengths[LENGTH_BUCKETS] = {};
+        uint64_t entropy[ENTROPY_BUCKETS] = {};
+
+        void add(const PasswordFeatures& f, PasswordStrength strength, unsigned failed_checks) {
+            ++passwords;
+            length_sum += f.length;
+            entropy_sum += f.entropy;
+            guesses_log10_sum += f.guesses_log10;
+            markov_bits_sum += f.markov_bits;
+            ++strengths[static_cast<size_t>(strength)];
+            for (unsigned i = 0; i < PolicyCheck::COUNT; ++i) rule_failures[i] += (failed_checks >> i) & 1u;
+            ++lengths[std::min(f.length, LENGTH_BUCKETS - 1)];
+            ++entropy[std::min(static_cast<size_t>(f.entropy / ENTROPY_BUCKET_BITS), ENTROPY_BUCKETS - 1)];
+        }
+
+        void merge(const StatsAccumulator& other) {
+            passwords += other.passwords;
+            bytes += other.bytes;
+            length_sum += other.length_sum;
+            entropy_sum += other.entropy_sum;
+            guesses_log10_sum += other.guesses_log10_sum;
+            markov_bits_sum += other.markov_bits_sum;
+            for (size_t i = 0; i < 4; ++i) strengths[i] += other.strengths[i];
+            for (size_t i = 0; i < PolicyCheck::COUNT; ++i) rule_failures[i] += other.rule_failures[i];
+            for (size_t i = 0; i < LENGTH_BUCKETS; ++i) lengths[i] += other.lengths[i];
+            for (size_t i = 0; i < ENTROPY_BUCKETS; ++i) entropy[i] += other.entropy[i];
+        }
+    };
+
+    // Hands out blocks of lines either straight from a memory-mapped file or from a reusable
+    // read buffer. Views stay valid until the next call to nextBlock.
+    class LineReader {
+    public:
+        explicit LineReader(const std::string& path) : stream_(nullptr), owns_stream_(false), position_(0), eof_(false) {
+            if (path.empty() || path == "-") {
+                stream_ = stdin;
+            } else {
+                try {
+                    mapping_ = MappedFile(path, MappedFileAccess::SEQUENTIAL);
+                }
+                catch (const std::exception&) {
+                    stream_ = std::fopen(path.c_str(), "rb");
+                    if (!stream_) throw std::runtime_error("Failed to open input: " + path);
+                    owns_stream_ = true;
+                }
+                if (!stream_ && !mapping_.isOpen()) eof_ = true;
+            }
+            if (stream_) buffer_.resize(READ_CHUNK);
+            buffer_begin_ = buffer_end_ = 0;
+        }
+
+        ~LineReader() {
+            if (owns_stream_) std::fclose(stream_);
+        }
+
+        bool nextBlock(std::vector<LineView>& lines, uint64_t& line_number) {
+            Trace::Span span("PasswordAudit::readBlock");
+            lines.clear();
+            if (mapping_.isOpen()) return nextMappedBlock(lines, line_number);
+            if (stream_) return nextStreamBlock(lines, line_number);
+            return false;
+        }
+
+    private:
+        MappedFile mapping_;
+        std::FILE* stream_;
+        bool owns_stream_;
+        size_t position_;
+        bool eof_;
+        std::vector<char> buffer_;
+        size_t buffer_begin_;
+        size_t buffer_end_;
+
+        static void addLine(std::vector<LineView>& lines, const char* data, size_t size, uint64_t& line_number) {
+            if (size > 0 && data[size - 1] == '\r') --size;
+            lines.push_back({ data, size, ++line_number });
+        }
+
+        bool nextMappedBlock(std::vector<LineView>& lines, uint64_t& line_number) {
+            const char* base = reinterpret_cast<const char*>(mapping_.data());
+            size_t size = mapping_.size();
+            while (position_ < size && lines.size() < BLOCK_LINES) {
+                const char* start = base + position_;
+                const char* newline = static_cast<const char*>(std::memchr(start, '\n', size - position_));
+                size_t length = newline ? static_cast<size_t>(newline - start) : size - position_;
+                addLine(lines, start, length, line_number);
+                position_ += length + 1;
+            }
+            return !lines.empty();
+        }
+
+        bool nextStreamBlock(std::vector<LineView>& lines, uint64_t& line_number) {
+            if (buffer_begin_ > 0) {
+                std::memmove(buffer_.data(), buffer_.data() + buffer_begin_, buffer_end_ - buffer_begin_);
+                buffer_end_ -= buffer_begin_;
+                buffer_begin_ = 0;
+            }
+
+            while (true) {
+                if (!eof_) {
+                    if (buffer_end_ == buffer_.size()) buffer_.resize(buffer_.size() * 2);
+                    size_t read = std::fread(buffer_.data() + buffer_end_, 1, buffer_.size() - buffer_end_, stream_);
+                    buffer_end_ += read;
+                    if (read == 0) eof_ = true;
+                }
+
+                const char* base = buffer_.data();
+                while (buffer_begin_ < buffer_end_ && lines.size() < BLOCK_LINES) {
+                    const char* start = base + buffer_begin_;
+                    const char* newline = static_cast<const char*>(std::memchr(start, '\n', buffer_end_ - buffer_begin_));
+                    if (!newline) break;
+                    addLine(lines, start, static_cast<size_t>(newline - start), line_number);
+                    buffer_begin_ += static_cast<size_t>(newline - start) + 1;
+                }
+
+                if (eof_ && lines.size() < BLOCK_LINES && buffer_begin_ < buffer_end_) {
+                    addLine(lines, base + buffer_begin_, buffer_end_ - buffer_begin_, line_number);
+                    buffer_begin_ = buffer_end_;
+                }
+                if (!lines.empty() || eof_) return !lines.empty();
+            }
+        }
+    };
+
+    class OutputWriter {
+    public:
+        explicit OutputWriter(const std::string& path) : file_(stdout), owns_file_(false) {
+            if (!path.empty() && path != "-") {
+                file_ = std::fopen(path.c_str(), "wb");
+                if (!file_) throw std::runtime_error("Failed to open output: " + path);
+                owns_file_ = true;
+            }
+            buffer_.reserve(OUTPUT_FLUSH * 2);
+        }
+
+        ~OutputWriter() {
+            flush();
+            if (owns_file_) std::fclose(file_);
+        }
+
+        void append(const char* data, size_t size) {
+            buffer_.append(data, size);
+            if (buffer_.size() >= OUTPUT_FLUSH) flush();
+        }
+
+        void append(const char* text) {
+            append(text, std::strlen(text));
+        }
+
+        void append(char c) {
+            buffer_.push_back(c);
+        }
+
+        void appendNumber(uint64_t value) {
+            char digits[24];
+            auto result = std::to_chars(digits, digits + sizeof(digits), value);
+            buffer_.append(digits, result.ptr);
+        }
+
+        void appendFixed(double value) {
+            char digits[64];
+            auto result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed, 2);
+            buffer_.append(digits, result.ptr);
+        }
+
+        void flush() {
+            if (!buffer_.empty()) std::fwrite(buffer_.data(), 1, buffer_.size(), file_);
+            buffer_.clear();
+            std::fflush(file_);
+        }
+
+    private:
+        std::FILE* file_;
+        bool owns_file_;
+        std::string buffer_;
+    };
+
+    void appendCsvField(OutputWriter& out, const char* data, size_t size) {
+        bool needs_quotes = false;
+        for (size_t i = 0; i < size && !needs_quotes; ++i) {
+            char c = data[i];
+            needs_quotes = c == ',' || c == '"' || c == '\n' || c == '\r';
+        }
+        if (!needs_quotes) {
+            out.append(data, size);
+            return;
+        }
+        out.append('"');
+        for (size_t i = 0; i < size; ++i) {
+            if (data[i] == '"') out.append('"');
+            out.append(data[i]);
+        }
+        out.append('"');
+    }
+
+    void appendJsonString(OutputWriter& out, const char* data, size_t size) {
+        static const char hex[] = "0123456789abcdef";
+        out.append('"');
+        for (size_t i = 0; i < size; ++i) {
+            unsigned char c = static_cast<unsigned char>(data[i]);
+            if (c == '"' || c == '\\') {
+                out.append('\\');
+                out.append(static_cast<char>(c));
+            } else if (c < 0x20) {
+                char escaped[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0x0F] };
+                out.append(escaped, sizeof(escaped));
+            } else {
+                out.append(static_cast<char>(c));
+            }
+        }
+        out.append('"');
+    }
+
+    // One yes/no column per check, named by PolicyCheck::NAMES and in bit order. ENTROPY is left out
+    // since the entropy column carries it.
+    constexpr unsigned FLAG_CHECKS = PolicyCheck::ALL & ~PolicyCheck::ENTROPY;
+
+    bool featureFlag(const PasswordFeatures& f, unsigned check) {
+        switch (check) {
+            case PolicyCheck::MIN_LENGTH: return f.meets_min_length;
+            case PolicyCheck::UPPER: return f.has_upper;
+            case PolicyCheck::LOWER: return f.has_lower;
+            case PolicyCheck::DIGIT: return f.has_digit;
+            case PolicyCheck::SPECIAL: return f.has_special;
+            case PolicyCheck::NO_REPEATS: return f.has_repeats;
+            case PolicyCheck::NO_SEQUENCE: return f.has_sequence;
+            case PolicyCheck::NO_COMMON_WORD: return f.has_common_word;
+            case PolicyCheck::NOT_BREACHED: return f.is_breached;
+            default: return false;
+        }
+    }
+
+    void writeHeader(OutputWriter& out, const AuditOptions& options) {
+        if (options.format != OutputFormat::CSV) return;
+        out.append("line,strength,entropy,length");
+        if (options.include_guesses) out.append(",guesses_log10");
+        if (options.include_markov) out.append(",markov_bits");
+        for (unsigned i = 0; i < PolicyCheck::COUNT; ++i) {
+            if ((FLAG_CHECKS & (1u << i)) == 0) continue;
+            out.append(',');
+            out.append(PolicyCheck::NAMES[i]);
+        }
+        if (options.include_password) out.append(",password");
+        out.append('\n');
+    }
+
+    void writeRow(OutputWriter& out, const AuditOptions& options, const LineView& line, const ScoredLine& scored) {
+        std::string_view strength = strengthName(scored.strength);
+
+        if (options.format == OutputFormat::CSV) {
+            out.appendNumber(line.number);
+            out.append(',');
+            out.append(strength.data(), strength.size());
+            out.append(',');
+            out.appendFixed(scored.features.entropy);
+            out.append(',');
+            out.appendNumber(scored.features.length);
+            if (options.include_guesses) {
+                out.append(',');
+                out.appendFixed(scored.features.guesses_log10);
+            }
+            if (options.include_markov) {
+                out.append(',');
+                out.appendFixed(scored.features.markov_bits);
+            }
+            for (unsigned i = 0; i < PolicyCheck::COUNT; ++i) {
+                if ((FLAG_CHECKS & (1u << i)) == 0) continue;
+                out.append(',');
+                out.append(featureFlag(scored.features, 1u << i) ? '1' : '0');
+            }
+            if (options.include_password) {
+                out.append(',');
+                appendCsvField(out, line.data, line.size);
+            }
+        } else {
+            out.append("{\"line\":");
+            out.appendNumber(line.number);
+            out.append(",\"strength\":\"");
+            out.append(strength.data(), strength.size());
+            out.append("\",\"entropy\":");
+            out.appendFixed(scored.features.entropy);
+            out.append(",\"length\":");
+            out.appendNumber(scored.features.length);
+            if (options.include_guesses) {
+                out.append(",\"guesses_log10\":");
+                out.appendFixed(scored.features.guesses_log10);
+            }
+            if (options.include_markov) {
+                out.append(",\"markov_bits\":");
+                out.appendFixed(scored.features.markov_bits);
+            }
+            for (unsigned i = 0; i < PolicyCheck::COUNT; ++i) {
+                if ((FLAG_CHECKS & (1u << i)) == 0) continue;
+                out.append(",\"");
+                out.append(PolicyCheck::NAMES[i]);
+                out.append(featureFlag(scored.features, 1u << i) ? "\":true" : "\":false");
+            }
+            if (options.include_password) {
+                out.append(",\"password\":");
+                appendJsonString(out, line.data, line.size);
+            }
+            out.append('}');
+        }
+        out.append('\n');
+    }
+
+    const char* const STRENGTH_KEYS[] = { "weak", "medium", "strong", "very_strong" };
+
+    void appendPercent(OutputWriter& out, uint64_t count, uint64_t total) {
+        out.appendFixed(total > 0 ? 100.0 * static_cast<double>(count) / static_cast<double>(total) : 0.0);
+        out.append('%');
+    }
+
+    void appendStatsRow(OutputWriter& out, const char* label, size_t label_size, uint64_t count, uint64_t total) {
+        out.append("  ");
+        out.append(label, label_size);
+        for (size_t i = label_size; i < 14; ++i) out.append(' ');
+        out.appendNumber(count);
+        out.append(" (");
+        appendPercent(out, count, total);
+        out.append(")\n");
+    }
+
+    void appendStatsRow(OutputWriter& out, const char* label, uint64_t count, uint64_t total) {
+        appendStatsRow(out, label, std::strlen(label), count, total);
+    }
+
+    void appendJsonArray(OutputWriter& out, const uint64_t* values, size_t count) {
+        out.append('[');
+        for (size_t i = 0; i < count; ++i) {
+            if (i > 0) out.append(',');
+            out.appendNumber(values[i]);
+        }
+        out.append(']');
+    }
+
+    void writeStatsText(OutputWriter& out, const AuditOptions& options, const PasswordChecker& checker,
+                        const StatsAccumulator& stats, uint64_t lines) {
+        double passwords = stats.passwords > 0 ? static_cast<double>(stats.passwords) : 1.0;
+        out.append("Passwords: ");
+        out.appendNumber(stats.passwords);
+        out.append(" (");
+        out.appendNumber(lines);
+        out.append(" lines)\nMean length: ");
+        out.appendFixed(static_cast<double>(stats.length_sum) / passwords);
+        out.append("\nMean entropy: ");
+        out.appendFixed(stats.entropy_sum / passwords);
+        out.append(" bits\n");
+        if (options.include_guesses) {
+            out.append("Mean guesses (log10): ");
+            out.appendFixed(stats.guesses_log10_sum / passwords);
+            out.append('\n');
+        }
+        if (options.include_markov) {
+            out.append("Mean Markov cost: ");
+            out.appendFixed(stats.markov_bits_sum / passwords);
+            out.append(" bits\n");
+        }
+
+        out.append("\nStrength:\n");
+        for (size_t i = 0; i < 4; ++i) {
+            std::string_view name = strengthName(static_cast<PasswordStrength>(i));
+            appendStatsRow(out, name.data(), name.size(), stats.strengths[i], stats.passwords);
+        }
+        out.append("\nRule failures:\n");
+        unsigned applied = checker.appliedChecks();
+        for (unsigned i = 0; i < PolicyCheck::COUNT; ++i) {
+            if ((applied & (1u << i)) != 0) appendStatsRow(out, PolicyCheck::NAMES[i], stats.rule_failures[i], stats.passwords);
+        }
+
+        char label[32];
+        out.append("\nLength:\n");
+        for (size_t i = 0; i < LENGTH_BUCKETS; ++i) {
+            if (stats.lengths[i] == 0) continue;
+            int size = std::snprintf(label, sizeof(label), i + 1 < LENGTH_BUCKETS ? "%zu" : "%zu+", i);
+            appendStatsRow(out, label, static_cast<size_t>(size), stats.lengths[i], stats.passwords);
+        }
+        out.append("\nEntropy (bits):\n");
+        for (size_t i = 0; i < ENTROPY_BUCKETS; ++i) {
+            if (stats.entropy[i] == 0) continue;
+            size_t low = i * ENTROPY_BUCKET_BITS;
+            int size = i + 1 < ENTROPY_BUCKETS
+                ? std::snprintf(label, sizeof(label), "%zu-%zu", low, low + ENTROPY_BUCKET_BITS)
+                : std::snprintf(label, sizeof(label), "%zu+", low);
+            appendStatsRow(out, label, static_cast<size_t>(size), stats.entropy[i], stats.passwords);
+        }
+    }
+
+    void writeStatsJson(OutputWriter& out, const AuditOptions& options, const PasswordChecker& checker,
+                        const StatsAccumulator& stats, uint64_t lines) {
+        double passwords = stats.passwords > 0 ? static_cast<double>(stats.passwords) : 1.0;
+        out.append("{\"passwords\":");
+        out.appendNumber(stats.passwords);
+        out.append(",\"lines\":");
+        out.appendNumber(lines);
+        out.append(",\"mean_length\":");
+        out.appendFixed(static_cast<double>(stats.length_sum) / passwords);
+        out.append(",\"mean_entropy\":");
+        out.appendFixed(stats.entropy_sum / passwords);
+        if (options.include_guesses) {
+            out.append(",\"mean_guesses_log10\":");
+            out.appendFixed(stats.guesses_log10_sum / passwords);
+        }
+        if (options.include_markov) {
+            out.append(",\"mean_markov_bits\":");
+            out.appendFixed(stats.markov_bits_sum / passwords);
+        }
+        out.append(",\"strength\":{");
+        for (size_t i = 0; i < 4; ++i) {
+            if (i > 0) out.append(',');
+            out.append('"');
+            out.append(STRENGTH_KEYS[i]);
+            out.append("\":");
+            out.appendNumber(stats.strengths[i]);
+        }
+        out.append("},\"rule_failures\":{");
+        unsigned applied = checker.appliedChecks();
+        bool first = true;
+        for (unsigned i = 0; i < PolicyCheck::COUNT; ++i) {
+            if ((applied & (1u << i)) == 0) continue;
+            if (!first) out.append(',');
+            first = false;
+            out.append('"');
+            out.append(PolicyCheck::NAMES[i]);
+            out.append("\":");
+            out.appendNumber(stats.rule_failures[i]);
+        }
+        out.append("},\"length_histogram\":");
+        appendJsonArray(out, stats.lengths, LENGTH_BUCKETS);
+        out.append(",\"entropy_bucket_bits\":");
+        out.appendNumber(ENTROPY_BUCKET_BITS);
+        out.append(",\"entropy_histogram\":");
+        appendJsonArray(out, stats.entropy, ENTROPY_BUCKETS);
+        out.append("}\n");
+    }
+
+    void printUsage(const char* program) {
+        std::cerr << "Usage: " << program << " [options] [input|-]\n"
+                  << "  Scores newline-delimited passwords and streams one result per line.\n"
+                  << "  --config FILE         load settings from FILE\n"
+                  << "  --format csv|jsonl    output format (default csv)\n"
+                  << "  --output FILE         write results to FILE instead of stdout\n"
+                  << "  --include-password    echo the password in every result row\n"
+                  << "  --stats               print one summary of the whole input instead of a row per password\n"
+                  << "  --threads N           scoring threads, 0 for all cores (default 1)\n"
+                  << "  --metrics FILE        write Prometheus metrics for the run to FILE\n"
+                  << "  --trace FILE          write a Chrome trace (chrome://tracing, Perfetto) of the run to FILE\n";
+    }
+
+    bool parseArguments(int argc, char* argv[], AuditOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--config" && i + 1 < argc) options.config_path = argv[++i];
+            else if (arg == "--output" && i + 1 < argc) options.output_path = argv[++i];
+            else if (arg == "--format" && i + 1 < argc) {
+                std::string value = argv[++i];
+                if (value == "csv") options.format = OutputFormat::CSV;
+                else if (value == "jsonl") options.format = OutputFormat::JSONL;
+                else return false;
+            }
+            else if (arg == "--include-password") options.include_password = true;
+            else if (arg == "--stats") options.stats = true;
+            else if (arg == "--threads" && i + 1 < argc) options.threads = std::stoul(argv[++i]);
+            else if (arg == "--metrics" && i + 1 < argc) options.metrics_path = argv[++i];
+            else if (arg == "--trace" && i + 1 < argc) options.trace_path = argv[++i];
+            else if (!arg.empty() && arg[0] == '-' && arg != "-") return false;
+            else if (options.input_path.empty()) options.input_path = arg;
+            else return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    AuditOptions options;
+    try {
+        if (!parseArguments(argc, argv, options)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    catch (const std::exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (!options.trace_path.empty()) {
+        if constexpr (!Trace::ENABLED) {
+            std::cerr << "Tracing was disabled at build time (PASSWORD_CHECKER_ENABLE_TRACING=OFF)\n";
+            return 1;
+        }
+        Trace::start();
+    }
+
+    try {
+        std::unique_ptr<ConfigManager> config = options.config_path.empty()
+            ? std::make_unique<ConfigManager>()
+            : std::make_unique<ConfigManager>(options.config_path);
+        PasswordChecker checker(*config);
+        options.include_guesses = config->getScoringMode() == ScoringMode::GUESSES;
+        options.include_markov = config->getMarkovModel() != nullptr;
+        ThreadPool pool(options.threads);
+        LineReader reader(options.input_path);
+        OutputWriter out(options.output_path);
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<LineView> lines;
+        std::vector<ScoredLine> scored;
+        uint64_t line_number = 0;
+        uint64_t scored_count = 0;
+        uint64_t bytes = 0;
+
+        if (options.stats) {
+            std::vector<StatsAccumulator> slots(STATS_SLOTS);
+            while (reader.nextBlock(lines, line_number)) {
+                pool.parallelFor(lines.size(), STATS_GRAIN, [&](size_t begin, size_t end) {
+                    Trace::Span span("PasswordAudit::accumulateStats");
+                    StatsAccumulator& slot = slots[begin / STATS_GRAIN];
+                    for (size_t i = begin; i < end; ++i) {
+                        slot.bytes += lines[i].size + 1;
+                        if (lines[i].size == 0) continue;
+                        PasswordFeatures features = checker.analyze(std::string_view(lines[i].data, lines[i].size));
+                        slot.add(features, checker.evaluateStrength(features), checker.failedChecks(features));
+                    }
+                });
+            }
+
+            StatsAccumulator stats;
+            for (const StatsAccumulator& slot : slots) stats.merge(slot);
+            scored_count = stats.passwords;
+            bytes = stats.bytes;
+            if (options.format == OutputFormat::JSONL) writeStatsJson(out, options, checker, stats, line_number);
+            else writeStatsText(out, options, checker, stats, line_number);
+        } else {
+            writeHeader(out, options);
+            while (reader.nextBlock(lines, line_number)) {
+                scored.resize(lines.size());
+                pool.parallelFor(lines.size(), 4096, [&](size_t begin, size_t end) {
+                    Trace::Span span("PasswordAudit::scoreLines");
+                    for (size_t i = begin; i < end; ++i) {
+                        if (lines[i].size == 0) continue;
+                        scored[i].features = checker.analyze(std::string_view(lines[i].data, lines[i].size));
+                        scored[i].strength = checker.evaluateStrength(scored[i].features);
+                    }
+                });
+
+                Trace::Span span("PasswordAudit::writeRows");
+                for (size_t i = 0; i < lines.size(); ++i) {
+                    bytes += lines[i].size + 1;
+                    if (lines[i].size == 0) continue;
+                    writeRow(out, options, lines[i], scored[i]);
+                    ++scored_count;
+                }
+            }
+        }
+        out.flush();
+
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cerr << "Scored " << scored_count << " passwords (" << line_number << " lines) in " << elapsed << " s, "
+                  << (elapsed > 0 ? bytes / elapsed / (1024.0 * 1024.0) : 0.0) << " MB/s\n";
+        if (!options.metrics_path.empty() &&
+            !Metrics::writeFile(options.metrics_path, Metrics::renderPrometheus(config.get(), checker.getCache()))) {
+            std::cerr << "Failed to write metrics to " << options.metrics_path << "\n";
+            return 1;
+        }
+        if (!options.trace_path.empty()) {
+            Trace::stop();
+            if (!Trace::writeFile(options.trace_path)) {
+                std::cerr << "Failed to write trace to " << options.trace_path << "\n";
+                return 1;
+            }
+            if (uint64_t dropped = Trace::getDroppedCount()) {
+                std::cerr << dropped << " trace spans dropped (per-thread buffer full)\n";
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -1,133 +1,142 @@
-#include "PasswordChecker.hpp"
-#include "Utils.hpp"
-#include <algorithm>
-#include <cmath>
-#include <set>
-#include <stdexcept>
-
-PasswordChecker::PasswordChecker(const ConfigManager& config) : config_(config) {}
-
-PasswordStrength PasswordChecker::checkPassword(const std::string& password) {
-    last_check_details_.clear();
-
-    if (password.empty()) {
-        last_check_details_ = "Password cannot be empty";
-        throw std::invalid_argument(last_check_details_);
-    }
-
-    bool length_ok = checkLength(password);
-    bool uppercase_ok = checkUpperCase(password);
-    bool lowercase_ok = checkLowerCase(password);
-    bool digits_ok = checkDigits(password);
-    bool special_ok = checkSpecialChars(password);
-    bool no_repeating_ok = checkNoRepeatingChars(password);
-    bool no_sequences_ok = checkNoSequences(password);
-    bool no_common_words_ok = checkNoCommonWords(password);
-    double entropy = calculateEntropy(password);
-
-    last_check_details_ += "Password Analysis:\n";
-    last_check_details_ += "- Length: " + std::string(length_ok ? "OK" : "Insufficient") + "\n";
-    last_check_details_ += "- Uppercase Letters: " + std::string(uppercase_ok ? "OK" : "Missing") + "\n";
-    last_check_details_ += "- Lowercase Letters: " + std::string(lowercase_ok ? "OK" : "Missing") + "\n";
-    last_check_details_ += "- Digits: " + std::string(digits_ok ? "OK" : "Missing") + "\n";
-    last_check_details_ += "- Special Characters: " + std::string(special_ok ? "OK" : "Missing") + "\n";
-    last_check_details_ += "- No Repeating Characters: " + std::string(no_repeating_ok ? "OK" : "Has Repeats") + "\n";
-    last_check_details_ += "- No Sequences: " + std::string(no_sequences_ok ? "OK" : "Has Sequences") + "\n";
-    last_check_details_ += "- No Common Words: " + std::string(no_common_words_ok ? "OK" : "Contains Common Words") + "\n";
-    last_check_details_ += "- Entropy: " + std::to_string(entropy) + " bits\n";
-
-    return evaluateStrength(password);
-}
-
-bool PasswordChecker::checkLength(const std::string& password) const {
-    return password.length() >= config_.getMinLength();
-}
-
-bool PasswordChecker::checkUpperCase(const std::string& password) const {
-    return std::any_of(password.begin(), password.end(), [](char c) { return std::isupper(c); });
-}
-
-bool PasswordChecker::checkLowerCase(const std::string& password) const {
-    return std::any_of(password.begin(), password.end(), [](char c) { return std::islower(c); });
-}
-
-bool PasswordChecker::checkDigits(const std::string& password) const {
-    return std::any_of(password.begin(), password.end(), [](char c) { return std::isdigit(c); });
-}
-
-bool PasswordChecker::checkSpecialChars(const std::string& password) const {
-    return std::any_of(password.begin(), password.end(), [](char c) {
-        return std::ispunct(c);
-        });
-}
-
-bool PasswordChecker::checkNoRepeatingChars(const std::string& password) const {
-    std::set<char> chars(password.begin(), password.end());
-    return chars.size() == password.length();
-}
-
-bool PasswordChecker::checkNoSequences(const std::string& password) const {
-    for (size_t i = 0; i < password.length() - 2; ++i) {
-        if (std::isalpha(password[i]) && std::isalpha(password[i + 1]) && std::isalpha(password[i + 2])) {
-            if (password[i + 1] == password[i] + 1 && password[i + 2] == password[i] + 2) {
-                return false;
-            }
-        }
-        if (std::isdigit(password[i]) && std::isdigit(password[i + 1]) && std::isdigit(password[i + 2])) {
-            if (password[i + 1] == password[i] + 1 && password[i + 2] == password[i] + 2) {
-                return false;
-            }
-        }
-    }
-    return true;
-}
-
-bool PasswordChecker::checkNoCommonWords(const std::string& password) const {
-    std::string lower_password = Utils::toLower(password);
-    for (const auto& word : config_.getCommonWords()) {
-        if (lower_password.find(word) != std::string::npos) {
-            return false;
-        }
-    }
-    return true;
-}
-
-double PasswordChecker::calculateEntropy(const std::string& password) const {
-    std::set<char> unique_chars(password.begin(), password.end());
-    double charset_size = unique_chars.size();
-    return password.length() * std::log2(charset_size);
-}
-
-PasswordStrength PasswordChecker::evaluateStrength(const std::string& password) {
-    int score = 0;
-    if (checkLength(password)) score += 20;
-    if (checkUpperCase(password)) score += 15;
-    if (checkLowerCase(password)) score += 15;
-    if (checkDigits(password)) score += 15;
-    if (checkSpecialChars(password)) score += 15;
-    if (checkNoRepeatingChars(password)) score += 10;
-    if (checkNoSequences(password)) score += 10;
-    if (checkNoCommonWords(password)) score += 10;
-    double entropy = calculateEntropy(password);
-    if (entropy > 50) score += 20;
-    else if (entropy > 30) score += 10;
-
-    if (score >= 90) return PasswordStrength::VERY_STRONG;
-    if (score >= 70) return PasswordStrength::STRONG;
-    if (score >= 50) return PasswordStrength::MEDIUM;
-    return PasswordStrength::WEAK;
-}
-
-std::string PasswordChecker::strengthToString(PasswordStrength strength) const {
-    switch (strength) {
-    case PasswordStrength::WEAK: return "Weak";
-    case PasswordStrength::MEDIUM: return "Medium";
-    case PasswordStrength::STRONG: return "Strong";
-    case PasswordStrength::VERY_STRONG: return "Very Strong";
-    default: return "Unknown";
-    }
-}
-
-std::string PasswordChecker::getLastCheckDetails() const {
-    return last_check_details_;
-}
+#include "PasswordChecker.hpp"
+#include <utility>
+
+PasswordCheckResult::PasswordCheckResult()
+    : strength_(PasswordStrength::WEAK),
+    report_lines_(0) {
+}
+
+PasswordCheckResult::PasswordCheckResult(PasswordStrength strength, const PasswordFeatures& features,
+                                         unsigned report_lines)
+    : strength_(strength),
+    report_lines_(report_lines),
+    features_(features) {
+}
+
+PasswordStrength PasswordCheckResult::getStrength() const {
+    return strength_;
+}
+
+const PasswordFeatures& PasswordCheckResult::getFeatures() const {
+    return features_;
+}
+
+bool PasswordCheckResult::isLengthOk() const {
+    return features_.meets_min_length;
+}
+
+double PasswordCheckResult::getEntropy() const {
+    return features_.entropy;
+}
+
+std::string PasswordCheckResult::getDetails() const {
+    std::string details;
+    details.reserve(384);
+    appendDetails(details);
+    return details;
+}
+
+void PasswordCheckResult::appendDetails(std::string& out) const {
+    Trace::Span span("PasswordCheckResult::appendDetails");
+    auto add_line = [this, &out](unsigned check, const char* label, const char* value) {
+        if ((report_lines_ & check) == 0) return;
+        out += label;
+        out += value;
+        out += '\n';
+    };
+
+    out += "Password Analysis:\n";
+    add_line(PolicyCheck::MIN_LENGTH, "- Length: ", features_.meets_min_length ? "OK" : "Insufficient");
+    add_line(PolicyCheck::UPPER, "- Uppercase Letters: ", features_.has_upper ? "OK" : "Missing");
+    add_line(PolicyCheck::LOWER, "- Lowercase Letters: ", features_.has_lower ? "OK" : "Missing");
+    add_line(PolicyCheck::DIGIT, "- Digits: ", features_.has_digit ? "OK" : "Missing");
+    add_line(PolicyCheck::SPECIAL, "- Special Characters: ", features_.has_special ? "OK" : "Missing");
+    add_line(PolicyCheck::NO_REPEATS, "- No Repeating Characters: ", !features_.has_repeats ? "OK" : "Has Repeats");
+    add_line(PolicyCheck::NO_SEQUENCE, "- No Sequences: ", !features_.has_sequence ? "OK" : "Has Sequences");
+    add_line(PolicyCheck::NO_COMMON_WORD, "- No Common Words: ", !features_.has_common_word ? "OK" : "Contains Common Words");
+    add_line(PolicyCheck::NOT_BREACHED, "- Not In Breach Corpus: ", !features_.is_breached ? "OK" : "Found In Breach Corpus");
+    out += "- Entropy: ";
+    out += std::to_string(features_.entropy);
+    out += " bits\n";
+    if ((report_lines_ & REPORT_GUESSES) != 0) {
+        out += "- Estimated Guesses: 10^";
+        out += std::to_string(features_.guesses_log10);
+        out += '\n';
+    }
+    if ((report_lines_ & REPORT_MARKOV) != 0) {
+        out += "- Markov Model Cost: ";
+        out += std::to_string(features_.markov_bits);
+        out += " bits\n";
+    }
+}
+
+CheckBatch::CheckBatch()
+    : results_(nullptr),
+    details_(nullptr),
+    count_(0) {
+}
+
+CheckBatch::CheckBatch(size_t count)
+    : arena_(count * sizeof(PasswordCheckResult) + alignof(PasswordCheckResult) + 4096),
+    results_(arena_.allocateArray<PasswordCheckResult>(count)),
+    details_(nullptr),
+    count_(count) {
+}
+
+CheckBatch::CheckBatch(CheckBatch&& other) noexcept
+    : arena_(std::move(other.arena_)),
+    results_(std::exchange(other.results_, nullptr)),
+    details_(std::exchange(other.details_, nullptr)),
+    count_(std::exchange(other.count_, 0)),
+    scratch_(std::move(other.scratch_)) {
+}
+
+CheckBatch& CheckBatch::operator=(CheckBatch&& other) noexcept {
+    if (this != &other) {
+        arena_ = std::move(other.arena_);
+        results_ = std::exchange(other.results_, nullptr);
+        details_ = std::exchange(other.details_, nullptr);
+        count_ = std::exchange(other.count_, 0);
+        scratch_ = std::move(other.scratch_);
+    }
+    return *this;
+}
+
+size_t CheckBatch::size() const {
+    return count_;
+}
+
+bool CheckBatch::empty() const {
+    return count_ == 0;
+}
+
+const PasswordCheckResult& CheckBatch::operator[](size_t index) const {
+    return results_[index];
+}
+
+const PasswordCheckResult* CheckBatch::begin() const {
+    return results_;
+}
+
+const PasswordCheckResult* CheckBatch::end() const {
+    return results_ + count_;
+}
+
+std::string_view CheckBatch::getDetails(size_t index) {
+    if (!details_) {
+        details_ = arena_.allocateArray<std::string_view>(count_);
+        for (size_t i = 0; i < count_; ++i) new (&details_[i]) std::string_view();
+    }
+    if (details_[index].empty()) {
+        scratch_.clear();
+        results_[index].appendDetails(scratch_);
+        details_[index] = arena_.store(scratch_);
+    }
+    return details_[index];
+}
+
+const Arena& CheckBatch::getArena() const {
+    return arena_;
+}
+
+template class BasicPasswordChecker<ConfigPolicy>;
\ No newline at end of file
@@ -1,37 +1,459 @@
-#ifndef PASSWORD_CHECKER_HPP
-#define PASSWORD_CHECKER_HPP
-#include <string>
-#include <vector>
-#include "ConfigManager.hpp"
-
-enum class PasswordStrength {
-    WEAK,
-    MEDIUM,
-    STRONG,
-    VERY_STRONG
-};
-
-class PasswordChecker {
-public:
-    explicit PasswordChecker(const ConfigManager& config);
-    PasswordStrength checkPassword(const std::string& password);
-    std::string strengthToString(PasswordStrength strength) const;
-    std::string getLastCheckDetails() const;
-
-private:
-    const ConfigManager& config_;
-    std::string last_check_details_;
-
-    bool checkLength(const std::string& password) const;
-    bool checkUpperCase(const std::string& password) const;
-    bool checkLowerCase(const std::string& password) const;
-    bool checkDigits(const std::string& password) const;
-    bool checkSpecialChars(const std::string& password) const;
-    bool checkNoRepeatingChars(const std::string& password) const;
-    bool checkNoSequences(const std::string& password) const;
-    bool checkNoCommonWords(const std::string& password) const;
-    double calculateEntropy(const std::string& password) const;
-    PasswordStrength evaluateStrength(const std::string& password);
-};
-
+#ifndef PASSWORD_CHECKER_HPP
+#define PASSWORD_CHECKER_HPP
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "Arena.hpp"
+#include "ConfigManager.hpp"
+#include "ConfigStore.hpp"
+#include "GuessEstimator.hpp"
+#include "IncrementalAnalyzer.hpp"
+#include "Metrics.hpp"
+#include "PasswordAnalyzer.hpp"
+#include "PasswordPolicy.hpp"
+#include "ResultCache.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+enum class PasswordStrength {
+    WEAK,
+    MEDIUM,
+    STRONG,
+    VERY_STRONG
+};
+
+// The display name of a strength. The text is static, so hot paths can use it without allocating.
+inline std::string_view strengthName(PasswordStrength strength) {
+    switch (strength) {
+    case PasswordStrength::WEAK: return "Weak";
+    case PasswordStrength::MEDIUM: return "Medium";
+    case PasswordStrength::STRONG: return "Strong";
+    case PasswordStrength::VERY_STRONG: return "Very Strong";
+    default: return "Unknown";
+    }
+}
+
+// The outcome of one check: the strength, the features it was computed from and which lines the
+// details report shows. The report is rendered from these only when asked for, so a result holds
+// no heap memory.
+class PasswordCheckResult {
+public:
+    // Report lines are the PolicyCheck bits of the checks that ran, plus these bits when the policy
+    // scores by estimated guesses and when the configuration has a Markov model.
+    static constexpr unsigned REPORT_GUESSES = 1u << 16;
+    static constexpr unsigned REPORT_MARKOV = 1u << 17;
+
+    PasswordCheckResult();
+    PasswordCheckResult(PasswordStrength strength, const PasswordFeatures& features, unsigned report_lines);
+
+    PasswordStrength getStrength() const;
+    const PasswordFeatures& getFeatures() const;
+    bool isLengthOk() const;
+    double getEntropy() const;
+    std::string getDetails() const;
+    void appendDetails(std::string& out) const;
+
+private:
+    PasswordStrength strength_;
+    unsigned report_lines_;
+    PasswordFeatures features_;
+};
+
+// The results of checkBatch. Results, and the reports rendered from them, are kept in an arena,
+// so a batch of any size costs a handful of large blocks rather than an allocation per password.
+class CheckBatch {
+public:
+    CheckBatch();
+
+    CheckBatch(const CheckBatch&) = delete;
+    CheckBatch& operator=(const CheckBatch&) = delete;
+    CheckBatch(CheckBatch&& other) noexcept;
+    CheckBatch& operator=(CheckBatch&& other) noexcept;
+
+    size_t size() const;
+    bool empty() const;
+    const PasswordCheckResult& operator[](size_t index) const;
+    const PasswordCheckResult* begin() const;
+    const PasswordCheckResult* end() const;
+
+    // Renders the report of one result on first use and keeps it in the arena. Not thread-safe.
+    std::string_view getDetails(size_t index);
+    const Arena& getArena() const;
+
+private:
+    template <typename Policy>
+    friend class BasicPasswordChecker;
+
+    Arena arena_;
+    PasswordCheckResult* results_;
+    std::string_view* details_;
+    size_t count_;
+    std::string scratch_;
+
+    explicit CheckBatch(size_t count);
+};
+
+// Scores passwords under the rules of Policy (see PasswordPolicy.hpp). The word list and breach
+// sources always come from the ConfigManager; the policy decides which checks run, the minimum
+// length, the weights and the strength thresholds.
+//
+// A checker built on a ConfigStore reads the store's current snapshot once per call, so checks
+// running during a reload see either the old or the new configuration, never a mix.
+//
+// Passwords are taken as string views and never copied, so they can be scored in place, for
+// example straight out of a memory-mapped file. analyze and evaluateStrength allocate nothing.
+template <typename Policy>
+class BasicPasswordChecker {
+public:
+    explicit BasicPasswordChecker(const ConfigManager& config);
+    explicit BasicPasswordChecker(const ConfigStore& store);
+    PasswordCheckResult check(std::string_view password) const;
+    // Scores the text of an analyzer kept in step with an input field. Only the breach lookup
+    // looks at the whole password again.
+    PasswordCheckResult check(const IncrementalAnalyzer& analyzer) const;
+    PasswordFeatures analyze(std::string_view password) const;
+    PasswordStrength evaluateStrength(const PasswordFeatures& features) const;
+    // PolicyCheck bits of the checks that take part in scoring under the current configuration:
+    // the policy's checks, only the length and breach checks when scoring by guesses, and no
+    // breach check without a breach source.
+    unsigned appliedChecks() const;
+    // The applied checks that features fail.
+    unsigned failedChecks(const PasswordFeatures& features) const;
+    CheckBatch checkBatch(const std::string* passwords, size_t count) const;
+    CheckBatch checkBatch(const std::string* passwords, size_t count, ThreadPool& pool) const;
+    CheckBatch checkBatch(const std::string_view* passwords, size_t count, ThreadPool& pool) const;
+    CheckBatch checkBatch(const std::vector<std::string>& passwords) const;
+    std::string strengthToString(PasswordStrength strength) const;
+
+    // Remembers the analysis of up to capacity passwords (see ResultCache.hpp). Copies of the
+    // checker share the cache. A capacity of 0 turns caching off.
+    void setCacheCapacity(size_t capacity);
+    const ResultCache* getCache() const;
+
+private:
+    static constexpr unsigned CHECKS = Policy::checks();
+
+    const ConfigManager* config_;
+    const ConfigStore* store_;
+    std::shared_ptr<ResultCache> cache_;
+
+    const ConfigManager& currentConfig() const;
+    PasswordFeatures analyze(const ConfigManager& config, std::string_view password) const;
+    PasswordFeatures analyzeUncached(const ConfigManager& config, std::string_view password) const;
+    void addConfigFeatures(const ConfigManager& config, std::string_view password, PasswordFeatures& features) const;
+    PasswordStrength evaluateStrength(const ConfigManager& config, const PasswordFeatures& features) const;
+    PasswordStrength scoreFeatures(const ConfigManager& config, const PasswordFeatures& features) const;
+    unsigned appliedChecks(const ConfigManager& config) const;
+    unsigned failedChecks(const ConfigManager& config, const PasswordFeatures& features) const;
+    bool checkBreached(const ConfigManager& config, std::string_view password) const;
+    template <typename Text>
+    CheckBatch checkEach(const Text* passwords, size_t count, ThreadPool& pool) const;
+    unsigned reportLines(const ConfigManager& config) const;
+    void recordCheck(const ConfigManager& config, const PasswordFeatures& features, PasswordStrength strength) const;
+};
+
+// The checker configured entirely at runtime through ConfigManager.
+using PasswordChecker = BasicPasswordChecker<ConfigPolicy>;
+
+template <typename Policy>
+BasicPasswordChecker<Policy>::BasicPasswordChecker(const ConfigManager& config)
+    : config_(&config),
+    store_(nullptr) {
+}
+
+template <typename Policy>
+BasicPasswordChecker<Policy>::BasicPasswordChecker(const ConfigStore& store)
+    : config_(nullptr),
+    store_(&store) {
+}
+
+template <typename Policy>
+const ConfigManager& BasicPasswordChecker<Policy>::currentConfig() const {
+    return store_ ? store_->current() : *config_;
+}
+
+template <typename Policy>
+PasswordCheckResult BasicPasswordChecker<Policy>::check(std::string_view password) const {
+    if (password.empty()) throw std::invalid_argument("Password cannot be empty");
+
+    Trace::Span span("PasswordChecker::check");
+    uint64_t start = Metrics::now();
+    const ConfigManager& config = currentConfig();
+    PasswordFeatures features = analyze(config, password);
+    Metrics::record(Metrics::ANALYZE_LATENCY, Metrics::since(start));
+    PasswordCheckResult result(evaluateStrength(config, features), features, reportLines(config));
+    Metrics::record(Metrics::CHECK_LATENCY, Metrics::since(start));
+    return result;
+}
+
+template <typename Policy>
+PasswordCheckResult BasicPasswordChecker<Policy>::check(const IncrementalAnalyzer& analyzer) const {
+    if (analyzer.text().empty()) throw std::invalid_argument("Password cannot be empty");
+
+    Trace::Span span("PasswordChecker::check");
+    uint64_t start = Metrics::now();
+    const ConfigManager& config = currentConfig();
+    PasswordFeatures features = analyzer.features();
+    if (Policy(config).encoding() == TextEncoding::UTF8 && !analyzer.isAscii()) {
+        // The analyzer counts bytes; re-measure the characters and keep its word match.
+        bool has_common_word = features.has_common_word;
+        features = PasswordAnalyzer::analyzeCharacters(analyzer.text(), TextEncoding::UTF8);
+        features.has_common_word = has_common_word;
+    }
+    if constexpr ((CHECKS & PolicyCheck::NO_COMMON_WORD) == 0) features.has_common_word = false;
+    addConfigFeatures(config, analyzer.text(), features);
+    PasswordCheckResult result(evaluateStrength(config, features), features, reportLines(config));
+    Metrics::record(Metrics::CHECK_LATENCY, Metrics::since(start));
+    return result;
+}
+
+template <typename Policy>
+PasswordFeatures BasicPasswordChecker<Policy>::analyze(std::string_view password) const {
+    uint64_t start = Metrics::now();
+    PasswordFeatures features = analyze(currentConfig(), password);
+    Metrics::record(Metrics::ANALYZE_LATENCY, Metrics::since(start));
+    return features;
+}
+
+template <typename Policy>
+PasswordFeatures BasicPasswordChecker<Policy>::analyze(const ConfigManager& config, std::string_view password) const {
+    if (!cache_) return analyzeUncached(config, password);
+
+    uint64_t key = cache_->key(password);
+    uint64_t generation = config.getGeneration();
+    PasswordFeatures features;
+    if (!cache_->find(key, generation, features)) {
+        features = analyzeUncached(config, password);
+        cache_->insert(key, generation, features);
+    }
+    return features;
+}
+
+template <typename Policy>
+PasswordFeatures BasicPasswordChecker<Policy>::analyzeUncached(const ConfigManager& config,
+                                                               std::string_view password) const {
+    PasswordFeatures features = PasswordAnalyzer::analyzeCharacters(password, Policy(config).encoding());
+    if constexpr ((CHECKS & PolicyCheck::NO_COMMON_WORD) != 0) {
+        features.has_common_word = config.getWordMatcher().containsAny(password);
+    }
+    addConfigFeatures(config, password, features);
+    return features;
+}
+
+template <typename Policy>
+void BasicPasswordChecker<Policy>::addConfigFeatures(const ConfigManager& config, std::string_view password,
+                                                     PasswordFeatures& features) const {
+    Policy policy(config);
+    features.meets_min_length = features.length >= policy.minLength();
+    if constexpr ((CHECKS & PolicyCheck::NOT_BREACHED) != 0) {
+        features.is_breached = checkBreached(config, password);
+    }
+    if (policy.scoring() == ScoringMode::GUESSES) {
+        features.guesses_log10 = GuessEstimator::log10Guesses(password, config.getWordMatcher());
+    }
+    if (const MarkovModel* model = config.getMarkovModel()) features.markov_bits = model->cost(password);
+}
+
+template <typename Policy>
+PasswordStrength BasicPasswordChecker<Policy>::evaluateStrength(const PasswordFeatures& features) const {
+    return evaluateStrength(currentConfig(), features);
+}
+
+template <typename Policy>
+PasswordStrength BasicPasswordChecker<Policy>::evaluateStrength(const ConfigManager& config,
+                                                                const PasswordFeatures& features) const {
+    PasswordStrength strength = scoreFeatures(config, features);
+    recordCheck(config, features, strength);
+    return strength;
+}
+
+template <typename Policy>
+unsigned BasicPasswordChecker<Policy>::appliedChecks() const {
+    return appliedChecks(currentConfig());
+}
+
+template <typename Policy>
+unsigned BasicPasswordChecker<Policy>::failedChecks(const PasswordFeatures& features) const {
+    return failedChecks(currentConfig(), features);
+}
+
+template <typename Policy>
+unsigned BasicPasswordChecker<Policy>::appliedChecks(const ConfigManager& config) const {
+    unsigned checks = CHECKS;
+    if (Policy(config).scoring() == ScoringMode::GUESSES) checks &= PolicyCheck::MIN_LENGTH | PolicyCheck::NOT_BREACHED;
+    if (!config.getBreachCorpus() && !config.getBreachFilter()) checks &= ~PolicyCheck::NOT_BREACHED;
+    return checks;
+}
+
+template <typename Policy>
+unsigned BasicPasswordChecker<Policy>::failedChecks(const ConfigManager& config, const PasswordFeatures& features) const {
+    constexpr const PolicyWeights& w = Policy::weights();
+    unsigned failed = 0;
+    if (!features.meets_min_length) failed |= PolicyCheck::MIN_LENGTH;
+    if (!features.has_upper) failed |= PolicyCheck::UPPER;
+    if (!features.has_lower) failed |= PolicyCheck::LOWER;
+    if (!features.has_digit) failed |= PolicyCheck::DIGIT;
+    if (!features.has_special) failed |= PolicyCheck::SPECIAL;
+    if (features.has_repeats) failed |= PolicyCheck::NO_REPEATS;
+    if (features.has_sequence) failed |= PolicyCheck::NO_SEQUENCE;
+    if (features.has_common_word) failed |= PolicyCheck::NO_COMMON_WORD;
+    // Entropy earns nothing at or below the medium threshold.
+    if (features.entropy <= w.entropy_medium_bits) failed |= PolicyCheck::ENTROPY;
+    if (features.is_breached) failed |= PolicyCheck::NOT_BREACHED;
+    return failed & appliedChecks(config);
+}
+
+template <typename Policy>
+PasswordStrength BasicPasswordChecker<Policy>::scoreFeatures(const ConfigManager& config,
+                                                             const PasswordFeatures& features) const {
+    Policy policy(config);
+    constexpr const PolicyWeights& w = Policy::weights();
+    constexpr const StrengthThresholds& t = Policy::thresholds();
+
+    if constexpr ((CHECKS & PolicyCheck::NOT_BREACHED) != 0) {
+        if (features.is_breached) return PasswordStrength::WEAK;
+    }
+
+    if (policy.scoring() == ScoringMode::GUESSES) {
+        // The length requirement still applies; every other check is subsumed by the estimate.
+        if constexpr ((CHECKS & PolicyCheck::MIN_LENGTH) != 0) {
+            if (!features.meets_min_length) return PasswordStrength::WEAK;
+        }
+        constexpr const GuessThresholds& g = Policy::guessThresholds();
+        if (features.guesses_log10 >= g.very_strong) return PasswordStrength::VERY_STRONG;
+        if (features.guesses_log10 >= g.strong) return PasswordStrength::STRONG;
+        if (features.guesses_log10 >= g.medium) return PasswordStrength::MEDIUM;
+        return PasswordStrength::WEAK;
+    }
+
+    int score = 0;
+    if constexpr ((CHECKS & PolicyCheck::MIN_LENGTH) != 0) {
+        if (features.meets_min_length) score += w.min_length;
+    }
+    if constexpr ((CHECKS & PolicyCheck::UPPER) != 0) {
+        if (features.has_upper) score += w.upper;
+    }
+    if constexpr ((CHECKS & PolicyCheck::LOWER) != 0) {
+        if (features.has_lower) score += w.lower;
+    }
+    if constexpr ((CHECKS & PolicyCheck::DIGIT) != 0) {
+        if (features.has_digit) score += w.digit;
+    }
+    if constexpr ((CHECKS & PolicyCheck::SPECIAL) != 0) {
+        if (features.has_special) score += w.special;
+    }
+    if constexpr ((CHECKS & PolicyCheck::NO_REPEATS) != 0) {
+        if (!features.has_repeats) score += w.no_repeats;
+    }
+    if constexpr ((CHECKS & PolicyCheck::NO_SEQUENCE) != 0) {
+        if (!features.has_sequence) score += w.no_sequence;
+    }
+    if constexpr ((CHECKS & PolicyCheck::NO_COMMON_WORD) != 0) {
+        if (!features.has_common_word) score += w.no_common_word;
+    }
+    if constexpr ((CHECKS & PolicyCheck::ENTROPY) != 0) {
+        if (features.entropy > w.entropy_high_bits) score += w.entropy_high;
+        else if (features.entropy > w.entropy_medium_bits) score += w.entropy_medium;
+    }
+
+    if (score >= t.very_strong) return PasswordStrength::VERY_STRONG;
+    if (score >= t.strong) return PasswordStrength::STRONG;
+    if (score >= t.medium) return PasswordStrength::MEDIUM;
+    return PasswordStrength::WEAK;
+}
+
+template <typename Policy>
+CheckBatch BasicPasswordChecker<Policy>::checkBatch(const std::string* passwords, size_t count) const {
+    return checkBatch(passwords, count, ThreadPool::shared());
+}
+
+template <typename Policy>
+CheckBatch BasicPasswordChecker<Policy>::checkBatch(const std::string* passwords, size_t count, ThreadPool& pool) const {
+    return checkEach(passwords, count, pool);
+}
+
+template <typename Policy>
+CheckBatch BasicPasswordChecker<Policy>::checkBatch(const std::string_view* passwords, size_t count,
+                                                    ThreadPool& pool) const {
+    return checkEach(passwords, count, pool);
+}
+
+template <typename Policy>
+CheckBatch BasicPasswordChecker<Policy>::checkBatch(const std::vector<std::string>& passwords) const {
+    return checkBatch(passwords.data(), passwords.size());
+}
+
+template <typename Policy>
+template <typename Text>
+CheckBatch BasicPasswordChecker<Policy>::checkEach(const Text* passwords, size_t count, ThreadPool& pool) const {
+    Trace::Span span("PasswordChecker::checkBatch");
+    uint64_t start = Metrics::now();
+    CheckBatch batch(count);
+    PasswordCheckResult* results = batch.results_;
+    std::thread::id caller = std::this_thread::get_id();
+    pool.parallelFor(count, 1024, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) new (&results[i]) PasswordCheckResult(check(std::string_view(passwords[i])));
+        // Pool workers may then sit idle indefinitely; do not let them keep a snapshot alive meanwhile.
+        if (store_ && std::this_thread::get_id() != caller) ConfigStore::releaseThreadSnapshots();
+    });
+    Metrics::record(Metrics::BATCH_LATENCY, Metrics::since(start));
+    return batch;
+}
+
+template <typename Policy>
+void BasicPasswordChecker<Policy>::setCacheCapacity(size_t capacity) {
+    if (capacity == 0) cache_.reset();
+    else cache_ = std::make_shared<ResultCache>(capacity);
+}
+
+template <typename Policy>
+const ResultCache* BasicPasswordChecker<Policy>::getCache() const {
+    return cache_.get();
+}
+
+template <typename Policy>
+bool BasicPasswordChecker<Policy>::checkBreached(const ConfigManager& config, std::string_view password) const {
+    Trace::Span span("PasswordChecker::checkBreached");
+    // The exact corpus wins when both are configured; the filter may report false positives.
+    if (const BreachCorpus* corpus = config.getBreachCorpus()) return corpus->contains(password);
+    if (const BreachFilter* filter = config.getBreachFilter()) return filter->contains(password);
+    return false;
+}
+
+template <typename Policy>
+void BasicPasswordChecker<Policy>::recordCheck(const ConfigManager& config, const PasswordFeatures& features,
+                                               PasswordStrength strength) const {
+    if constexpr (Metrics::ENABLED) {
+        static_assert(Metrics::RULE_BREACHED - Metrics::RULE_MIN_LENGTH + 1 == PolicyCheck::COUNT,
+                      "Rule counters follow the PolicyCheck bits");
+        Metrics::ThreadBlock& block = Metrics::block();
+        Metrics::bump(block.counters[Metrics::CHECKS_WEAK + static_cast<unsigned>(strength)], 1);
+        unsigned failed = failedChecks(config, features);
+        for (unsigned i = 0; i < PolicyCheck::COUNT; ++i) {
+            if ((failed & (1u << i)) != 0) Metrics::bump(block.counters[Metrics::RULE_MIN_LENGTH + i], 1);
+        }
+    }
+}
+
+template <typename Policy>
+std::string BasicPasswordChecker<Policy>::strengthToString(PasswordStrength strength) const {
+    return std::string(strengthName(strength));
+}
+
+template <typename Policy>
+unsigned BasicPasswordChecker<Policy>::reportLines(const ConfigManager& config) const {
+    unsigned lines = CHECKS;
+    // Without a breach source the breach check cannot fail, so the report leaves it out.
+    if (!config.getBreachCorpus() && !config.getBreachFilter()) lines &= ~PolicyCheck::NOT_BREACHED;
+    if (Policy(config).scoring() == ScoringMode::GUESSES) lines |= PasswordCheckResult::REPORT_GUESSES;
+    if (config.getMarkovModel()) lines |= PasswordCheckResult::REPORT_MARKOV;
+    return lines;
+}
+
+extern template class BasicPasswordChecker<ConfigPolicy>;
+
 #endif
\ No newline at end of file
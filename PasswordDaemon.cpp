@@ -0,0 +1,611 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "ConfigManager.hpp"
+#include "ConfigStore.hpp"
+#include "DaemonProtocol.hpp"
+#include "Metrics.hpp"
+#include "PasswordChecker.hpp"
+
+namespace {
+    constexpr size_t READ_CHUNK = size_t(64) << 10;
+    constexpr size_t MAX_PENDING_OUTPUT = size_t(1) << 20;
+    constexpr int MAX_EVENTS = 256;
+    constexpr size_t MAX_HTTP_REQUEST = 8192;
+
+    struct DaemonOptions {
+        std::string socket_path;
+        std::string config_path;
+        size_t threads = 1;
+        size_t cache_capacity = 0;
+        std::string metrics_file;
+        unsigned metrics_interval = 15;
+        int metrics_port = -1;
+    };
+
+    int stop_event_fd = -1;
+
+    void handleStopSignal(int) {
+        uint64_t one = 1;
+        ssize_t ignored = write(stop_event_fd, &one, sizeof(one));
+        (void)ignored;
+    }
+
+    std::runtime_error systemError(const std::string& what) {
+        return std::runtime_error(what + ": " + std::strerror(errno));
+    }
+
+    struct Connection {
+        int fd;
+        std::vector<char> input;
+        size_t input_begin = 0;
+        size_t input_end = 0;
+        std::string output;
+        size_t output_begin = 0;
+        uint32_t events = 0;
+        bool paused = false;
+        bool closing = false;
+
+        size_t pendingOutput() const {
+            return output.size() - output_begin;
+        }
+    };
+
+    // One epoll loop per thread. All loops watch the shared listening socket with EPOLLEXCLUSIVE,
+    // so each new connection wakes a single loop and stays with it for its lifetime.
+    class EventLoop {
+    public:
+        EventLoop(int listen_fd, int stop_fd, const PasswordChecker& checker)
+            : listen_fd_(listen_fd), stop_fd_(stop_fd), checker_(checker) {
+            epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+            if (epoll_fd_ < 0) throw systemError("epoll_create1");
+            addDescriptor(listen_fd_, EPOLLIN | EPOLLEXCLUSIVE);
+            addDescriptor(stop_fd_, EPOLLIN);
+        }
+
+        ~EventLoop() {
+            for (auto& entry : connections_) close(entry.first);
+            close(epoll_fd_);
+        }
+
+        EventLoop(const EventLoop&) = delete;
+        EventLoop& operator=(const EventLoop&) = delete;
+
+        void run() {
+            epoll_event events[MAX_EVENTS];
+            while (true) {
+                int ready = epoll_wait(epoll_fd_, events, MAX_EVENTS, -1);
+                if (ready < 0) {
+                    if (errno == EINTR) continue;
+                    throw systemError("epoll_wait");
+                }
+                for (int i = 0; i < ready; ++i) {
+                    int fd = events[i].data.fd;
+                    if (fd == stop_fd_) return;
+                    if (fd == listen_fd_) {
+                        acceptConnections();
+                        continue;
+                    }
+                    auto it = connections_.find(fd);
+                    if (it == connections_.end()) continue;
+                    handleEvents(*it->second, events[i].events);
+                }
+            }
+        }
+
+    private:
+        int epoll_fd_;
+        int listen_fd_;
+        int stop_fd_;
+        const PasswordChecker& checker_;
+        std::unordered_map<int, std::unique_ptr<Connection>> connections_;
+
+        void addDescriptor(int fd, uint32_t events) {
+            epoll_event event = {};
+            event.events = events;
+            event.data.fd = fd;
+            if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) throw systemError("epoll_ctl");
+        }
+
+        void acceptConnections() {
+            while (true) {
+                int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (fd < 0) {
+                    if (errno == EINTR) continue;
+                    // EAGAIN means another loop took it; anything else (EMFILE, ...) is retried
+                    // on the next wakeup rather than taking the daemon down.
+                    return;
+                }
+                auto connection = std::make_unique<Connection>();
+                connection->fd = fd;
+                connection->input.resize(READ_CHUNK);
+                connection->events = EPOLLIN;
+                addDescriptor(fd, connection->events);
+                connections_[fd] = std::move(connection);
+            }
+        }
+
+        void handleEvents(Connection& connection, uint32_t events) {
+            if (events & (EPOLLIN | EPOLLHUP | EPOLLERR)) readInput(connection);
+            if (!connection.closing || connection.pendingOutput() > 0) {
+                if (!writeOutput(connection)) {
+                    closeConnection(connection.fd);
+                    return;
+                }
+            }
+            if (connection.paused && connection.pendingOutput() < MAX_PENDING_OUTPUT / 2) {
+                connection.paused = false;
+                processFrames(connection);
+                if (!writeOutput(connection)) {
+                    closeConnection(connection.fd);
+                    return;
+                }
+            }
+            if (connection.closing && connection.pendingOutput() == 0) {
+                closeConnection(connection.fd);
+                return;
+            }
+            updateInterest(connection);
+        }
+
+        void readInput(Connection& connection) {
+            if (connection.paused || connection.closing) return;
+            if (connection.input_begin > 0) {
+                std::memmove(connection.input.data(), connection.input.data() + connection.input_begin,
+                             connection.input_end - connection.input_begin);
+                connection.input_end -= connection.input_begin;
+                connection.input_begin = 0;
+            }
+            if (connection.input.size() - connection.input_end < READ_CHUNK / 2) {
+                connection.input.resize(connection.input.size() + READ_CHUNK);
+            }
+
+            ssize_t received = read(connection.fd, connection.input.data() + connection.input_end,
+                                    connection.input.size() - connection.input_end);
+            if (received > 0) {
+                connection.input_end += static_cast<size_t>(received);
+                processFrames(connection);
+            } else if (received == 0 || (errno != EAGAIN && errno != EINTR)) {
+                // Peer closed its side: answer what already arrived, then close.
+                connection.closing = true;
+            }
+        }
+
+        void processFrames(Connection& connection) {
+            using namespace DaemonProtocol;
+
+            while (!connection.paused && connection.input_end - connection.input_begin >= HEADER_SIZE) {
+                const char* frame = connection.input.data() + connection.input_begin;
+                uint32_t length = loadU32(frame);
+                Response response = {};
+                response.type = static_cast<MessageType>(frame[4]);
+                response.id = loadU32(frame + 5);
+
+                if (length < HEADER_SIZE - LENGTH_SIZE || length - (HEADER_SIZE - LENGTH_SIZE) > MAX_PASSWORD_SIZE) {
+                    // The stream cannot be resynchronized after a bad length, so report and hang up.
+                    response.status = length < HEADER_SIZE - LENGTH_SIZE ? Status::BAD_REQUEST : Status::TOO_LARGE;
+                    appendResponse(connection.output, response);
+                    connection.closing = true;
+                    connection.input_begin = connection.input_end;
+                    return;
+                }
+                if (connection.input_end - connection.input_begin < LENGTH_SIZE + length) break;
+
+                const char* body = frame + HEADER_SIZE;
+                size_t body_size = length - (HEADER_SIZE - LENGTH_SIZE);
+                if (response.type == MessageType::CHECK) {
+                    uint64_t start = Metrics::now();
+                    scorePassword(body, body_size, response);
+                    Metrics::record(Metrics::REQUEST_LATENCY, Metrics::since(start));
+                } else if (response.type == MessageType::PING) {
+                    response.status = Status::OK;
+                } else {
+                    response.status = Status::BAD_REQUEST;
+                }
+                appendResponse(connection.output, response);
+
+                connection.input_begin += LENGTH_SIZE + length;
+                if (connection.pendingOutput() >= MAX_PENDING_OUTPUT) connection.paused = true;
+            }
+        }
+
+        void scorePassword(const char* data, size_t size, DaemonProtocol::Response& response) {
+            using namespace DaemonProtocol;
+
+            if (size == 0) {
+                response.status = Status::EMPTY_PASSWORD;
+                return;
+            }
+            // Scored in place in the connection buffer; no copy of the password is made.
+            PasswordFeatures features = checker_.analyze(std::string_view(data, size));
+
+            uint16_t flags = 0;
+            if (features.meets_min_length) flags |= MEETS_MIN_LENGTH;
+            if (features.has_upper) flags |= HAS_UPPER;
+            if (features.has_lower) flags |= HAS_LOWER;
+            if (features.has_digit) flags |= HAS_DIGIT;
+            if (features.has_special) flags |= HAS_SPECIAL;
+            if (features.has_repeats) flags |= HAS_REPEATS;
+            if (features.has_sequence) flags |= HAS_SEQUENCE;
+            if (features.has_common_word) flags |= HAS_COMMON_WORD;
+            if (features.is_breached) flags |= IS_BREACHED;
+
+            response.status = Status::OK;
+            response.strength = static_cast<uint8_t>(checker_.evaluateStrength(features));
+            response.flags = flags;
+            response.entropy_centibits = static_cast<uint32_t>(features.entropy * 100.0 + 0.5);
+        }
+
+        bool writeOutput(Connection& connection) {
+            while (connection.pendingOutput() > 0) {
+                ssize_t sent = send(connection.fd, connection.output.data() + connection.output_begin,
+                                    connection.pendingOutput(), MSG_NOSIGNAL);
+                if (sent > 0) {
+                    connection.output_begin += static_cast<size_t>(sent);
+                } else if (sent < 0 && errno == EINTR) {
+                    continue;
+                } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    break;
+                } else {
+                    return false;
+                }
+            }
+            if (connection.output_begin == connection.output.size()) {
+                connection.output.clear();
+                connection.output_begin = 0;
+            }
+            return true;
+        }
+
+        void updateInterest(Connection& connection) {
+            uint32_t events = 0;
+            if (!connection.paused && !connection.closing) events |= EPOLLIN;
+            if (connection.pendingOutput() > 0) events |= EPOLLOUT;
+            if (events == connection.events) return;
+
+            epoll_event event = {};
+            event.events = events;
+            event.data.fd = connection.fd;
+            if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, connection.fd, &event) < 0) {
+                closeConnection(connection.fd);
+                return;
+            }
+            connection.events = events;
+        }
+
+        void closeConnection(int fd) {
+            epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+            close(fd);
+            connections_.erase(fd);
+        }
+    };
+
+    // $XDG_RUNTIME_DIR/password_checker.sock, or the same name in a directory under /tmp that only
+    // this user can enter, so other local users cannot take the name or swap the socket.
+    std::string defaultSocketPath() {
+        const char* runtime_dir = std::getenv("XDG_RUNTIME_DIR");
+        if (runtime_dir && runtime_dir[0] == '/') return std::string(runtime_dir) + "/password_checker.sock";
+
+        std::string directory = "/tmp/password_checker-" + std::to_string(getuid());
+        if (mkdir(directory.c_str(), 0700) < 0 && errno != EEXIST) throw systemError("Failed to create " + directory);
+        struct stat info;
+        if (lstat(directory.c_str(), &info) < 0) throw systemError("Failed to inspect " + directory);
+        if (!S_ISDIR(info.st_mode) || info.st_uid != getuid() || (info.st_mode & 077) != 0) {
+            throw std::runtime_error(directory + " is not a private directory owned by this user");
+        }
+        return directory + "/password_checker.sock";
+    }
+
+    sockaddr_un socketAddress(const std::string& path) {
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+            throw std::runtime_error("Socket path is empty or too long: " + path);
+        }
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        return address;
+    }
+
+    // Removes a socket left behind by a daemon that is no longer running. Anything that is not a
+    // socket, or a socket someone still answers on, is left alone and reported.
+    void removeStaleSocket(const std::string& path, const sockaddr_un& address) {
+        struct stat info;
+        if (lstat(path.c_str(), &info) < 0) {
+            if (errno == ENOENT) return;
+            throw systemError("Failed to inspect " + path);
+        }
+        if (!S_ISSOCK(info.st_mode)) throw std::runtime_error(path + " exists and is not a socket");
+
+        int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (probe < 0) throw systemError("socket");
+        int result = connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+        int saved = errno;
+        close(probe);
+        if (result == 0) throw std::runtime_error(path + " is in use by another process");
+        if (saved != ECONNREFUSED) {
+            errno = saved;
+            throw systemError("Failed to probe " + path);
+        }
+        if (unlink(path.c_str()) < 0 && errno != ENOENT) throw systemError("Failed to remove stale socket " + path);
+    }
+
+    // Binds and listens on path and records which file the socket became, so that shutdown only
+    // removes that file and not whatever may have replaced it.
+    int openListeningSocket(const std::string& path, struct stat& identity) {
+        sockaddr_un address = socketAddress(path);
+        removeStaleSocket(path, address);
+
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) throw systemError("socket");
+        if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(fd, SOMAXCONN) < 0 ||
+            lstat(path.c_str(), &identity) < 0) {
+            int saved = errno;
+            close(fd);
+            errno = saved;
+            throw systemError("Failed to listen on " + path);
+        }
+        return fd;
+    }
+
+    void removeOwnSocket(const std::string& path, const struct stat& identity) {
+        struct stat info;
+        if (lstat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode) && info.st_dev == identity.st_dev &&
+            info.st_ino == identity.st_ino) {
+            unlink(path.c_str());
+        }
+    }
+
+    int openMetricsSocket(int port) {
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) throw systemError("socket");
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(fd, 16) < 0) {
+            int saved = errno;
+            close(fd);
+            errno = saved;
+            throw systemError("Failed to listen on 127.0.0.1:" + std::to_string(port));
+        }
+        return fd;
+    }
+
+    void sendAll(int fd, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t written = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (written < 0 && errno == EINTR) continue;
+            if (written <= 0) return;
+            sent += static_cast<size_t>(written);
+        }
+    }
+
+    // Just enough HTTP/1.1 for a Prometheus scraper: read the request head, answer GET /metrics,
+    // close the connection.
+    void answerScrape(int fd, const ConfigStore& config, const PasswordChecker& checker) {
+        timeval timeout = { 2, 0 };
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+        std::string request;
+        char buffer[1024];
+        while (request.find("\r\n\r\n") == std::string::npos && request.size() < MAX_HTTP_REQUEST) {
+            ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+            if (received < 0 && errno == EINTR) continue;
+            if (received <= 0) return;
+            request.append(buffer, static_cast<size_t>(received));
+        }
+
+        std::string status = "200 OK";
+        std::string body;
+        if (request.compare(0, 4, "GET ") != 0) {
+            status = "405 Method Not Allowed";
+        } else if (request.compare(4, 9, "/metrics ") != 0 && request.compare(4, 2, "/ ") != 0) {
+            status = "404 Not Found";
+        } else {
+            body = Metrics::renderPrometheus(config.snapshot().get(), checker.getCache());
+        }
+        sendAll(fd, "HTTP/1.1 " + status + "\r\n"
+                    "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                    "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                    "Connection: close\r\n\r\n" + body);
+    }
+
+    void dumpMetrics(const std::string& filename, const ConfigStore& config, const PasswordChecker& checker) {
+        if (!Metrics::writeFile(filename, Metrics::renderPrometheus(config.snapshot().get(), checker.getCache()))) {
+            std::cerr << "Failed to write metrics to " << filename << "\n";
+        }
+    }
+
+    // Serves scrapes and rewrites the metrics file until the stop event fires. Scrapes are rare,
+    // so one blocking connection at a time is plenty.
+    void exportMetrics(int http_fd, int stop_fd, const DaemonOptions& options, const ConfigStore& config,
+                       const PasswordChecker& checker) {
+        using Clock = std::chrono::steady_clock;
+        auto interval = std::chrono::seconds(std::max(1u, options.metrics_interval));
+        auto next_dump = Clock::now() + interval;
+
+        while (true) {
+            int timeout = -1;
+            if (!options.metrics_file.empty()) {
+                auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(next_dump - Clock::now());
+                timeout = static_cast<int>(std::max<int64_t>(0, remaining.count()));
+            }
+            pollfd fds[2] = { { stop_fd, POLLIN, 0 }, { http_fd, POLLIN, 0 } };
+            int ready = poll(fds, http_fd >= 0 ? 2 : 1, timeout);
+            if (ready < 0 && errno != EINTR) throw systemError("poll");
+            if (fds[0].revents & POLLIN) return;
+
+            if (ready > 0 && (fds[1].revents & POLLIN)) {
+                int fd = accept4(http_fd, nullptr, nullptr, SOCK_CLOEXEC);
+                if (fd >= 0) {
+                    answerScrape(fd, config, checker);
+                    close(fd);
+                }
+            }
+            if (!options.metrics_file.empty() && Clock::now() >= next_dump) {
+                dumpMetrics(options.metrics_file, config, checker);
+                next_dump = Clock::now() + interval;
+            }
+        }
+    }
+
+    void printUsage(const char* program) {
+        std::cerr << "Usage: " << program << " [options]\n"
+                  << "  Answers password checks over a Unix domain socket (see DaemonProtocol.hpp).\n"
+                  << "  --socket PATH         socket to listen on (default $XDG_RUNTIME_DIR/password_checker.sock,\n"
+                  << "                        or /tmp/password_checker-UID/password_checker.sock)\n"
+                  << "  --config FILE         load settings from FILE and reload them when it changes\n"
+                  << "  --threads N           event loop threads, 0 for all cores (default 1)\n"
+                  << "  --cache N             remember the results of up to N recent passwords (default off)\n"
+                  << "  --metrics-file FILE   write Prometheus metrics to FILE periodically and on exit\n"
+                  << "  --metrics-interval S  seconds between metrics file updates (default 15)\n"
+                  << "  --metrics-port N      serve Prometheus metrics at http://127.0.0.1:N/metrics\n";
+    }
+
+    bool parseArguments(int argc, char* argv[], DaemonOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--socket" && i + 1 < argc) options.socket_path = argv[++i];
+            else if (arg == "--config" && i + 1 < argc) options.config_path = argv[++i];
+            else if (arg == "--threads" && i + 1 < argc) options.threads = std::stoul(argv[++i]);
+            else if (arg == "--cache" && i + 1 < argc) options.cache_capacity = std::stoul(argv[++i]);
+            else if (arg == "--metrics-file" && i + 1 < argc) options.metrics_file = argv[++i];
+            else if (arg == "--metrics-interval" && i + 1 < argc) options.metrics_interval = std::stoul(argv[++i]);
+            else if (arg == "--metrics-port" && i + 1 < argc) options.metrics_port = std::stoi(argv[++i]);
+            else return false;
+        }
+        if (options.threads == 0) options.threads = std::max(1u, std::thread::hardware_concurrency());
+        if (options.metrics_port > 65535) return false;
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    DaemonOptions options;
+    try {
+        if (!parseArguments(argc, argv, options)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    catch (const std::exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    int listen_fd = -1;
+    int metrics_fd = -1;
+    struct stat socket_identity = {};
+    try {
+        if (options.socket_path.empty()) options.socket_path = defaultSocketPath();
+        std::unique_ptr<ConfigStore> config = options.config_path.empty()
+            ? std::make_unique<ConfigStore>()
+            : std::make_unique<ConfigStore>(ConfigManager(options.config_path));
+        if (!options.config_path.empty()) {
+            config->watchFile(options.config_path, [](bool, const std::string& message) {
+                std::cerr << message << "\n";
+            });
+        }
+        PasswordChecker checker(*config);
+        checker.setCacheCapacity(options.cache_capacity);
+
+        stop_event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (stop_event_fd < 0) throw systemError("eventfd");
+        std::signal(SIGPIPE, SIG_IGN);
+        std::signal(SIGINT, handleStopSignal);
+        std::signal(SIGTERM, handleStopSignal);
+
+        listen_fd = openListeningSocket(options.socket_path, socket_identity);
+        std::cerr << "Listening on " << options.socket_path << " with " << options.threads << " thread(s)\n";
+        if (options.metrics_port >= 0) {
+            metrics_fd = openMetricsSocket(options.metrics_port);
+            std::cerr << "Serving metrics on http://127.0.0.1:" << options.metrics_port << "/metrics\n";
+        }
+
+        std::vector<std::unique_ptr<EventLoop>> loops;
+        for (size_t i = 0; i < options.threads; ++i) {
+            loops.push_back(std::make_unique<EventLoop>(listen_fd, stop_event_fd, checker));
+        }
+        std::vector<std::thread> threads;
+        if (metrics_fd >= 0 || !options.metrics_file.empty()) {
+            threads.emplace_back([&] {
+                try {
+                    exportMetrics(metrics_fd, stop_event_fd, options, *config, checker);
+                }
+                catch (const std::exception& e) {
+                    std::cerr << "Error: " << e.what() << "\n";
+                    handleStopSignal(0);
+                }
+            });
+        }
+        for (size_t i = 1; i < loops.size(); ++i) {
+            threads.emplace_back([&loops, i] {
+                try {
+                    loops[i]->run();
+                }
+                catch (const std::exception& e) {
+                    std::cerr << "Error: " << e.what() << "\n";
+                    handleStopSignal(0);
+                }
+            });
+        }
+        try {
+            loops[0]->run();
+        }
+        catch (...) {
+            handleStopSignal(0);
+            for (auto& thread : threads) thread.join();
+            throw;
+        }
+        for (auto& thread : threads) thread.join();
+        if (!options.metrics_file.empty()) dumpMetrics(options.metrics_file, *config, checker);
+
+        if (const ResultCache* cache = checker.getCache()) {
+            ResultCache::Stats stats = cache->getStats();
+            std::cerr << "Cache: " << stats.hits << " hits, " << stats.misses << " misses ("
+                      << stats.hitRate() * 100.0 << "% hit rate), " << stats.evictions << " evictions, "
+                      << stats.entries << "/" << stats.capacity << " entries, "
+                      << stats.memory_bytes / 1024 << " KiB\n";
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        if (metrics_fd >= 0) close(metrics_fd);
+        if (listen_fd >= 0) {
+            close(listen_fd);
+            removeOwnSocket(options.socket_path, socket_identity);
+        }
+        return 1;
+    }
+
+    if (metrics_fd >= 0) close(metrics_fd);
+    close(listen_fd);
+    removeOwnSocket(options.socket_path, socket_identity);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "PasswordGenerator.hpp"
+#include "CharClass.hpp"
+#include "SecureRandom.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    const char UPPER[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    const char LOWER[] = "abcdefghijklmnopqrstuvwxyz";
+    const char DIGITS[] = "0123456789";
+    const char SPECIAL[] = "!@#$%^&*()_+-=[]{}|;:,.<>?";
+
+    constexpr size_t RANDOM_CHUNK = 256;
+    constexpr size_t BATCH_GRAIN = 4096;
+
+    // Hands out 16-bit random values from a local buffer refilled in chunks, and wipes it afterwards.
+    class RandomSource {
+    public:
+        explicit RandomSource(size_t chunk) : chunk_(std::min(chunk, RANDOM_CHUNK)), position_(chunk_) {
+        }
+
+        ~RandomSource() {
+            std::memset(values_, 0, sizeof(values_));
+        }
+
+        uint16_t next() {
+            if (position_ == chunk_) {
+                SecureRandom::fill(values_, chunk_ * sizeof(uint16_t));
+                position_ = 0;
+            }
+            return values_[position_++];
+        }
+
+    private:
+        uint16_t values_[RANDOM_CHUNK];
+        size_t chunk_;
+        size_t position_;
+    };
+
+    void drawPassword(const std::string& charset, uint32_t reject_below, uint8_t required_classes,
+                      size_t length, RandomSource& source, char* out) {
+        uint32_t size = static_cast<uint32_t>(charset.size());
+        do {
+            for (size_t i = 0; i < length; ++i) {
+                // Lemire's multiply-shift: the high half is the index, and the rare low halves
+                // below reject_below are redrawn so every index is equally likely.
+                uint32_t product = uint32_t(source.next()) * size;
+                while ((product & 0xFFFF) < reject_below) product = uint32_t(source.next()) * size;
+                out[i] = charset[product >> 16];
+            }
+        } while ((CharClass::classify(out, length) & required_classes) != required_classes);
+    }
+}
+
+PasswordGenerator::PasswordGenerator(size_t length, bool include_upper, bool include_lower,
+                                     bool include_digits, bool include_special)
+    : required_classes_(0) {
+    size_t set_count = 0;
+    auto add_set = [&](bool enabled, const char* chars, uint8_t cls) {
+        if (!enabled) return;
+        charset_ += chars;
+        required_classes_ |= cls;
+        ++set_count;
+    };
+    add_set(include_upper, UPPER, CharClass::UPPER);
+    add_set(include_lower, LOWER, CharClass::LOWER);
+    add_set(include_digits, DIGITS, CharClass::DIGIT);
+    add_set(include_special, SPECIAL, CharClass::SPECIAL);
+
+    if (charset_.empty()) throw std::invalid_argument("At least one character set must be included");
+    length_ = std::max(length, set_count);
+    reject_below_ = 65536 % static_cast<uint32_t>(charset_.size());
+}
+
+size_t PasswordGenerator::getLength() const {
+    return length_;
+}
+
+const std::string& PasswordGenerator::getCharset() const {
+    return charset_;
+}
+
+std::string PasswordGenerator::generate() const {
+    std::string password(length_, '\0');
+    generate(&password[0]);
+    return password;
+}
+
+void PasswordGenerator::generate(char* out) const {
+    RandomSource source(length_ + length_ / 4 + 4);
+    drawPassword(charset_, reject_below_, required_classes_, length_, source, out);
+}
+
+std::string PasswordGenerator::generateBatch(size_t count) const {
+    return generateBatch(count, ThreadPool::shared());
+}
+
+std::string PasswordGenerator::generateBatch(size_t count, ThreadPool& pool) const {
+    size_t stride = length_ + 1;
+    std::string buffer(count * stride, '\n');
+    pool.parallelFor(count, BATCH_GRAIN, [&](size_t begin, size_t end) {
+        RandomSource source(RANDOM_CHUNK);
+        for (size_t i = begin; i < end; ++i) {
+            drawPassword(charset_, reject_below_, required_classes_, length_, source, &buffer[i * stride]);
+        }
+    });
+    return buffer;
+}
\ No newline at end of file
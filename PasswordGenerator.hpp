@@ -0,0 +1,35 @@
+#ifndef PASSWORD_GENERATOR_HPP
+#define PASSWORD_GENERATOR_HPP
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "ThreadPool.hpp"
+
+// Random passwords drawn from SecureRandom. Every character is picked uniformly from the enabled
+// character sets, and a password missing one of the enabled sets is thrown away and drawn again,
+// so the result is uniform over all passwords of the length that use every set.
+class PasswordGenerator {
+public:
+    PasswordGenerator(size_t length, bool include_upper = true, bool include_lower = true,
+                      bool include_digits = true, bool include_special = true);
+
+    // At least one character per enabled set, so it may exceed the requested length.
+    size_t getLength() const;
+    const std::string& getCharset() const;
+
+    std::string generate() const;
+    // Writes getLength() characters to out.
+    void generate(char* out) const;
+    // count passwords in one buffer, each getLength() characters followed by '\n'.
+    std::string generateBatch(size_t count) const;
+    std::string generateBatch(size_t count, ThreadPool& pool) const;
+
+private:
+    std::string charset_;
+    uint8_t required_classes_;
+    size_t length_;
+    // 16-bit draws whose product with the charset size has a low half below this are rejected.
+    uint32_t reject_below_;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,110 @@
+#ifndef PASSWORD_POLICY_HPP
+#define PASSWORD_POLICY_HPP
+#include <cstddef>
+#include "ConfigManager.hpp"
+
+// Checks a policy can turn on or off. A disabled check is never computed and earns no points.
+namespace PolicyCheck {
+    enum : unsigned {
+        MIN_LENGTH = 1 << 0,
+        UPPER = 1 << 1,
+        LOWER = 1 << 2,
+        DIGIT = 1 << 3,
+        SPECIAL = 1 << 4,
+        NO_REPEATS = 1 << 5,
+        NO_SEQUENCE = 1 << 6,
+        NO_COMMON_WORD = 1 << 7,
+        ENTROPY = 1 << 8,
+        NOT_BREACHED = 1 << 9,
+        ALL = (1 << 10) - 1
+    };
+
+    constexpr unsigned COUNT = 10;
+    // Short names of the checks, by bit position, as metrics and reports label them.
+    constexpr const char* NAMES[COUNT] = {
+        "min_length", "upper", "lower", "digit", "special", "repeats", "sequence", "common_word", "entropy", "breached"
+    };
+}
+
+struct PolicyWeights {
+    int min_length;
+    int upper;
+    int lower;
+    int digit;
+    int special;
+    int no_repeats;
+    int no_sequence;
+    int no_common_word;
+    int entropy_high;
+    int entropy_medium;
+    double entropy_high_bits;
+    double entropy_medium_bits;
+};
+
+// Lowest score for each strength above WEAK.
+struct StrengthThresholds {
+    int medium;
+    int strong;
+    int very_strong;
+};
+
+// Lowest log10 guess count for each strength above WEAK when scoring by estimated guesses. The
+// defaults put online-throttled attacks (10^6) and fast offline attacks (10^10) at the boundaries.
+struct GuessThresholds {
+    double medium;
+    double strong;
+    double very_strong;
+};
+
+// The rules every checker used before policies existed. Compile-time policies usually derive from
+// this and shadow the members they change:
+//
+//     struct KioskRules : DefaultPolicyRules {
+//         static constexpr size_t MIN_LENGTH = 12;
+//         static constexpr unsigned CHECKS = PolicyCheck::ALL & ~PolicyCheck::NOT_BREACHED;
+//     };
+//     BasicPasswordChecker<StaticPolicy<KioskRules>> checker(config);
+struct DefaultPolicyRules {
+    static constexpr unsigned CHECKS = PolicyCheck::ALL;
+    static constexpr size_t MIN_LENGTH = 8;
+    static constexpr PolicyWeights WEIGHTS = { 20, 15, 15, 15, 15, 10, 10, 10, 20, 10, 50.0, 30.0 };
+    static constexpr StrengthThresholds THRESHOLDS = { 50, 70, 90 };
+    static constexpr ScoringMode SCORING = ScoringMode::CHECKLIST;
+    static constexpr GuessThresholds GUESS_THRESHOLDS = { 6.0, 8.0, 10.0 };
+    static constexpr TextEncoding ENCODING = TextEncoding::BYTES;
+};
+
+// Rules fixed at compile time. Every accessor is constexpr, so the checker built on it folds the
+// weights and thresholds into its code and drops disabled checks entirely.
+template <typename Rules>
+class StaticPolicy {
+public:
+    explicit StaticPolicy(const ConfigManager&) {}
+
+    static constexpr unsigned checks() { return Rules::CHECKS; }
+    static constexpr size_t minLength() { return Rules::MIN_LENGTH; }
+    static constexpr const PolicyWeights& weights() { return Rules::WEIGHTS; }
+    static constexpr const StrengthThresholds& thresholds() { return Rules::THRESHOLDS; }
+    static constexpr ScoringMode scoring() { return Rules::SCORING; }
+    static constexpr const GuessThresholds& guessThresholds() { return Rules::GUESS_THRESHOLDS; }
+    static constexpr TextEncoding encoding() { return Rules::ENCODING; }
+};
+
+// Rules read from a ConfigManager on every check, so settings changed at runtime apply at once.
+class ConfigPolicy {
+public:
+    explicit ConfigPolicy(const ConfigManager& config) : config_(config) {}
+
+    static constexpr unsigned checks() { return PolicyCheck::ALL; }
+    size_t minLength() const { return config_.getMinLength(); }
+    static constexpr const PolicyWeights& weights() { return DefaultPolicyRules::WEIGHTS; }
+    static constexpr const StrengthThresholds& thresholds() { return DefaultPolicyRules::THRESHOLDS; }
+    ScoringMode scoring() const { return config_.getScoringMode(); }
+    static constexpr const GuessThresholds& guessThresholds() { return DefaultPolicyRules::GUESS_THRESHOLDS; }
+    TextEncoding encoding() const { return config_.getTextEncoding(); }
+
+private:
+    const ConfigManager& config_;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "ResultCache.hpp"
+#include <algorithm>
+
+namespace {
+    constexpr size_t SHARD_COUNT = 16;
+    constexpr size_t WAYS = 4;
+
+    // Generation 0 never occurs in a ConfigManager, so it marks a free way.
+    constexpr uint64_t EMPTY = 0;
+}
+
+struct ResultCache::Set {
+    uint64_t keys[WAYS] = {};
+    uint64_t generations[WAYS] = {};
+    PasswordFeatures features[WAYS];
+    uint8_t referenced = 0;
+    uint8_t hand = 0;
+};
+
+struct alignas(64) ResultCache::Shard {
+    std::mutex mutex;
+    std::unique_ptr<Set[]> sets;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t entries = 0;
+};
+
+double ResultCache::Stats::hitRate() const {
+    uint64_t lookups = hits + misses;
+    return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+}
+
+ResultCache::ResultCache(size_t capacity)
+    : sip_key_(Hash::randomSipKey()),
+    sets_per_shard_(1),
+    shards_(new Shard[SHARD_COUNT]) {
+    size_t sets_needed = (std::max<size_t>(capacity, 1) + SHARD_COUNT * WAYS - 1) / (SHARD_COUNT * WAYS);
+    while (sets_per_shard_ < sets_needed) sets_per_shard_ <<= 1;
+    for (size_t i = 0; i < SHARD_COUNT; ++i) shards_[i].sets.reset(new Set[sets_per_shard_]);
+}
+
+ResultCache::~ResultCache() = default;
+
+uint64_t ResultCache::key(std::string_view password) const {
+    return Hash::sipHash24(sip_key_, password.data(), password.size());
+}
+
+bool ResultCache::find(uint64_t key, uint64_t generation, PasswordFeatures& features) {
+    // The top bits pick the shard and the low bits the set, so the two choices are independent.
+    Shard& shard = shards_[key >> 60];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    Set& set = shard.sets[key & (sets_per_shard_ - 1)];
+    for (size_t way = 0; way < WAYS; ++way) {
+        if (set.keys[way] == key && set.generations[way] == generation) {
+            set.referenced |= static_cast<uint8_t>(1u << way);
+            features = set.features[way];
+            ++shard.hits;
+            return true;
+        }
+    }
+    ++shard.misses;
+    return false;
+}
+
+void ResultCache::insert(uint64_t key, uint64_t generation, const PasswordFeatures& features) {
+    Shard& shard = shards_[key >> 60];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    Set& set = shard.sets[key & (sets_per_shard_ - 1)];
+
+    // Reuse the way already holding this key, then a free or stale way, before evicting anything.
+    size_t victim = WAYS;
+    for (size_t way = 0; way < WAYS && victim == WAYS; ++way) {
+        if (set.keys[way] == key && set.generations[way] != EMPTY) victim = way;
+    }
+    for (size_t way = 0; way < WAYS && victim == WAYS; ++way) {
+        if (set.generations[way] != generation) victim = way;
+    }
+    if (victim == WAYS) {
+        while (set.referenced & (1u << set.hand)) {
+            set.referenced &= static_cast<uint8_t>(~(1u << set.hand));
+            set.hand = static_cast<uint8_t>((set.hand + 1) % WAYS);
+        }
+        victim = set.hand;
+        set.hand = static_cast<uint8_t>((set.hand + 1) % WAYS);
+        ++shard.evictions;
+    }
+
+    if (set.generations[victim] == EMPTY) ++shard.entries;
+    set.keys[victim] = key;
+    set.generations[victim] = generation;
+    set.features[victim] = features;
+    set.referenced |= static_cast<uint8_t>(1u << victim);
+}
+
+void ResultCache::clear() {
+    for (size_t i = 0; i < SHARD_COUNT; ++i) {
+        Shard& shard = shards_[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        std::fill(shard.sets.get(), shard.sets.get() + sets_per_shard_, Set());
+        shard.entries = 0;
+    }
+}
+
+ResultCache::Stats ResultCache::getStats() const {
+    Stats stats;
+    for (size_t i = 0; i < SHARD_COUNT; ++i) {
+        Shard& shard = shards_[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        stats.hits += shard.hits;
+        stats.misses += shard.misses;
+        stats.evictions += shard.evictions;
+        stats.entries += shard.entries;
+    }
+    stats.capacity = SHARD_COUNT * sets_per_shard_ * WAYS;
+    stats.memory_bytes = sizeof(*this) + SHARD_COUNT * (sizeof(Shard) + sets_per_shard_ * sizeof(Set));
+    return stats;
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef RESULT_CACHE_HPP
+#define RESULT_CACHE_HPP
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include "Hash.hpp"
+#include "PasswordAnalyzer.hpp"
+
+// Bounded cache of analysis results for passwords that are checked again and again (form
+// validation, retries, the daemon). Entries are keyed by a SipHash of the password under a key
+// drawn at random for each cache, so no plaintext and no unkeyed digest is ever kept in memory.
+//
+// The cache is split into shards, each behind its own mutex, holding 4-way sets replaced with the
+// CLOCK policy. Every entry records the ConfigManager generation it was computed under; an entry
+// from an older generation is treated as empty, so changing the configuration invalidates the
+// whole cache at no cost. A hit costs one hash and one probe of a single set.
+class ResultCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t capacity = 0;
+        size_t memory_bytes = 0;
+
+        double hitRate() const;
+    };
+
+    // Capacity is rounded up so every shard holds a power of two sets.
+    explicit ResultCache(size_t capacity);
+    ~ResultCache();
+
+    uint64_t key(std::string_view password) const;
+    bool find(uint64_t key, uint64_t generation, PasswordFeatures& features);
+    void insert(uint64_t key, uint64_t generation, const PasswordFeatures& features);
+    void clear();
+
+    Stats getStats() const;
+
+private:
+    struct Set;
+    struct Shard;
+
+    Hash::SipKey sip_key_;
+    size_t sets_per_shard_;
+    std::unique_ptr<Shard[]> shards_;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,207 @@
+#include "SecureRandom.hpp"
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+// SSE2 is part of the x86-64 baseline, so it needs no runtime check.
+#if defined(__x86_64__) || defined(_M_X64)
+#define SECURE_RANDOM_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    constexpr size_t BLOCK_SIZE = 64;
+    constexpr size_t BLOCKS_PER_REFILL = 16;
+    constexpr size_t KEY_SIZE = 32;
+    constexpr size_t BUFFER_SIZE = BLOCK_SIZE * BLOCKS_PER_REFILL;
+
+    inline uint32_t rotl(uint32_t x, int n) {
+        return (x << n) | (x >> (32 - n));
+    }
+
+    inline uint32_t loadLittleEndian32(const uint8_t* bytes) {
+        return uint32_t(bytes[0]) | (uint32_t(bytes[1]) << 8) | (uint32_t(bytes[2]) << 16) | (uint32_t(bytes[3]) << 24);
+    }
+
+    inline void storeLittleEndian32(uint8_t* bytes, uint32_t value) {
+        bytes[0] = static_cast<uint8_t>(value);
+        bytes[1] = static_cast<uint8_t>(value >> 8);
+        bytes[2] = static_cast<uint8_t>(value >> 16);
+        bytes[3] = static_cast<uint8_t>(value >> 24);
+    }
+
+#ifndef SECURE_RANDOM_SSE2
+    inline void quarterRound(uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d) {
+        a += b; d ^= a; d = rotl(d, 16);
+        c += d; b ^= c; b = rotl(b, 12);
+        a += b; d ^= a; d = rotl(d, 8);
+        c += d; b ^= c; b = rotl(b, 7);
+    }
+
+    // One ChaCha20 block (RFC 8439) for the given key, 64-bit block counter and zero nonce.
+    void chachaBlock(const uint32_t key[8], uint64_t counter, uint8_t* out) {
+        uint32_t input[16] = {
+            0x61707865, 0x3320646E, 0x79622D32, 0x6B206574,
+            key[0], key[1], key[2], key[3], key[4], key[5], key[6], key[7],
+            static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32), 0, 0
+        };
+        uint32_t x[16];
+        std::memcpy(x, input, sizeof(x));
+        for (int round = 0; round < 10; ++round) {
+            quarterRound(x[0], x[4], x[8], x[12]);
+            quarterRound(x[1], x[5], x[9], x[13]);
+            quarterRound(x[2], x[6], x[10], x[14]);
+            quarterRound(x[3], x[7], x[11], x[15]);
+            quarterRound(x[0], x[5], x[10], x[15]);
+            quarterRound(x[1], x[6], x[11], x[12]);
+            quarterRound(x[2], x[7], x[8], x[13]);
+            quarterRound(x[3], x[4], x[9], x[14]);
+        }
+        for (int i = 0; i < 16; ++i) storeLittleEndian32(out + i * 4, x[i] + input[i]);
+    }
+#else
+    template <int N>
+    inline __m128i rotlVector(__m128i x) {
+        return _mm_or_si128(_mm_slli_epi32(x, N), _mm_srli_epi32(x, 32 - N));
+    }
+
+    inline void quarterRoundVector(__m128i& a, __m128i& b, __m128i& c, __m128i& d) {
+        a = _mm_add_epi32(a, b); d = rotlVector<16>(_mm_xor_si128(d, a));
+        c = _mm_add_epi32(c, d); b = rotlVector<12>(_mm_xor_si128(b, c));
+        a = _mm_add_epi32(a, b); d = rotlVector<8>(_mm_xor_si128(d, a));
+        c = _mm_add_epi32(c, d); b = rotlVector<7>(_mm_xor_si128(b, c));
+    }
+
+    // Four consecutive blocks at once, one block per 32-bit lane; same output as four chachaBlock
+    // calls with counter .. counter + 3.
+    void chachaBlocks4(const uint32_t key[8], uint64_t counter, uint8_t* out) {
+        __m128i input[16];
+        static const uint32_t CONSTANTS[4] = { 0x61707865, 0x3320646E, 0x79622D32, 0x6B206574 };
+        for (int i = 0; i < 4; ++i) input[i] = _mm_set1_epi32(static_cast<int>(CONSTANTS[i]));
+        for (int i = 0; i < 8; ++i) input[4 + i] = _mm_set1_epi32(static_cast<int>(key[i]));
+        uint64_t c0 = counter, c1 = counter + 1, c2 = counter + 2, c3 = counter + 3;
+        input[12] = _mm_setr_epi32(static_cast<int>(c0), static_cast<int>(c1), static_cast<int>(c2), static_cast<int>(c3));
+        input[13] = _mm_setr_epi32(static_cast<int>(c0 >> 32), static_cast<int>(c1 >> 32),
+                                   static_cast<int>(c2 >> 32), static_cast<int>(c3 >> 32));
+        input[14] = _mm_setzero_si128();
+        input[15] = _mm_setzero_si128();
+
+        __m128i x[16];
+        for (int i = 0; i < 16; ++i) x[i] = input[i];
+        for (int round = 0; round < 10; ++round) {
+            quarterRoundVector(x[0], x[4], x[8], x[12]);
+            quarterRoundVector(x[1], x[5], x[9], x[13]);
+            quarterRoundVector(x[2], x[6], x[10], x[14]);
+            quarterRoundVector(x[3], x[7], x[11], x[15]);
+            quarterRoundVector(x[0], x[5], x[10], x[15]);
+            quarterRoundVector(x[1], x[6], x[11], x[12]);
+            quarterRoundVector(x[2], x[7], x[8], x[13]);
+            quarterRoundVector(x[3], x[4], x[9], x[14]);
+        }
+
+        // Transpose each group of four words so every block comes out contiguous.
+        for (int i = 0; i < 16; i += 4) {
+            __m128i a = _mm_add_epi32(x[i], input[i]);
+            __m128i b = _mm_add_epi32(x[i + 1], input[i + 1]);
+            __m128i c = _mm_add_epi32(x[i + 2], input[i + 2]);
+            __m128i d = _mm_add_epi32(x[i + 3], input[i + 3]);
+            __m128i ab_low = _mm_unpacklo_epi32(a, b), ab_high = _mm_unpackhi_epi32(a, b);
+            __m128i cd_low = _mm_unpacklo_epi32(c, d), cd_high = _mm_unpackhi_epi32(c, d);
+            uint8_t* word = out + i * 4;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(word), _mm_unpacklo_epi64(ab_low, cd_low));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(word + BLOCK_SIZE), _mm_unpackhi_epi64(ab_low, cd_low));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(word + 2 * BLOCK_SIZE), _mm_unpacklo_epi64(ab_high, cd_high));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(word + 3 * BLOCK_SIZE), _mm_unpackhi_epi64(ab_high, cd_high));
+        }
+    }
+#endif
+
+    class ChaChaStream {
+    public:
+        void fill(uint8_t* out, size_t size) {
+            while (size > 0) {
+                if (position_ == BUFFER_SIZE) refill();
+                size_t take = std::min(size, BUFFER_SIZE - position_);
+                std::memcpy(out, buffer_ + position_, take);
+                // Bytes handed out are erased so they cannot be read back from this state.
+                std::memset(buffer_ + position_, 0, take);
+                position_ += take;
+                out += take;
+                size -= take;
+            }
+        }
+
+        uint32_t nextU32() {
+            if (BUFFER_SIZE - position_ < 4) {
+                uint8_t bytes[4];
+                fill(bytes, sizeof(bytes));
+                return loadLittleEndian32(bytes);
+            }
+            uint32_t value = loadLittleEndian32(buffer_ + position_);
+            std::memset(buffer_ + position_, 0, 4);
+            position_ += 4;
+            return value;
+        }
+
+        void reset() {
+            seeded_ = false;
+            position_ = BUFFER_SIZE;
+        }
+
+    private:
+        uint32_t key_[8] = {};
+        uint8_t buffer_[BUFFER_SIZE] = {};
+        size_t position_ = BUFFER_SIZE;
+        bool seeded_ = false;
+
+        void refill() {
+            if (!seeded_) {
+                std::random_device device;
+                for (uint32_t& word : key_) word = device();
+                seeded_ = true;
+            }
+#ifdef SECURE_RANDOM_SSE2
+            for (size_t i = 0; i < BLOCKS_PER_REFILL; i += 4) chachaBlocks4(key_, i, buffer_ + i * BLOCK_SIZE);
+#else
+            for (size_t i = 0; i < BLOCKS_PER_REFILL; ++i) chachaBlock(key_, i, buffer_ + i * BLOCK_SIZE);
+#endif
+            // The first 32 bytes become the next key and are never handed out.
+            for (int i = 0; i < 8; ++i) key_[i] = loadLittleEndian32(buffer_ + i * 4);
+            std::memset(buffer_, 0, KEY_SIZE);
+            position_ = KEY_SIZE;
+        }
+    };
+
+    ChaChaStream& threadStream() {
+        thread_local ChaChaStream stream;
+        return stream;
+    }
+}
+
+namespace SecureRandom {
+    void fill(void* out, size_t size) {
+        threadStream().fill(static_cast<uint8_t*>(out), size);
+    }
+
+    uint32_t nextU32() {
+        return threadStream().nextU32();
+    }
+
+    uint32_t uniform(uint32_t bound) {
+        // Lemire's multiply-shift, rejecting the few products that would favour low values.
+        uint64_t product = uint64_t(nextU32()) * bound;
+        uint32_t low = static_cast<uint32_t>(product);
+        if (low < bound) {
+            uint32_t threshold = (0u - bound) % bound;
+            while (low < threshold) {
+                product = uint64_t(nextU32()) * bound;
+                low = static_cast<uint32_t>(product);
+            }
+        }
+        return static_cast<uint32_t>(product >> 32);
+    }
+
+    void reseed() {
+        threadStream().reset();
+    }
+}
\ No newline at end of file
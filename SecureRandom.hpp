@@ -0,0 +1,19 @@
+#ifndef SECURE_RANDOM_HPP
+#define SECURE_RANDOM_HPP
+#include <cstddef>
+#include <cstdint>
+
+// Cryptographically secure random numbers for password generation. Each thread owns a ChaCha20
+// keystream seeded from the operating system, produced sixteen blocks at a time into a buffer.
+// After every refill the key is replaced with fresh keystream ("fast key erasure"), so a state
+// captured later cannot reproduce earlier output. All functions are thread-safe without locks.
+namespace SecureRandom {
+    void fill(void* out, size_t size);
+    uint32_t nextU32();
+    // Uniform in [0, bound) with no modulo bias; bound must be nonzero.
+    uint32_t uniform(uint32_t bound);
+    // Discards this thread's state so the next call reseeds from the operating system.
+    void reseed();
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,307 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BreachCorpus.hpp"
+#include "ConfigManager.hpp"
+#include "ConfigStore.hpp"
+#include "GuessEstimator.hpp"
+#include "Hash.hpp"
+#include "Metrics.hpp"
+#include "PasswordChecker.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+#include "WordMatcher.hpp"
+
+namespace {
+    int failures = 0;
+
+    void expect(bool condition, const std::string& what) {
+        if (condition) return;
+        std::fprintf(stderr, "FAILED: %s\n", what.c_str());
+        ++failures;
+    }
+
+    // A repeat costs its base token's guesses times the number of repeats, whatever the length of
+    // the token, plus the one guess the estimator adds to every decomposition.
+    void testRepeatedTokens() {
+        WordMatcher words({ "password", "qwerty", "dragon", "hello" });
+        struct Case {
+            const char* password;
+            const char* base;
+            int count;
+        };
+        const Case cases[] = {
+            { "qwerty123qwerty123", "qwerty123", 2 },
+            { "dragon12dragon12", "dragon12", 2 },
+            { "hellohellohello", "hello", 3 },
+            { "passwordpasswordpassword", "password", 3 },
+            { "abcxyz!abcxyz!", "abcxyz!", 2 },
+        };
+        for (const Case& c : cases) {
+            double repeated = GuessEstimator::log10Guesses(c.password, words);
+            double base = GuessEstimator::log10Guesses(c.base, words);
+            double expected = std::log10(std::pow(10.0, base) * c.count + 1.0);
+            expect(repeated <= expected + 1e-9,
+                   std::string(c.password) + ": " + std::to_string(repeated) + " > " + std::to_string(expected));
+        }
+    }
+
+    double secondsToEstimate(const std::vector<std::string>& passwords, const WordMatcher& words) {
+        double fastest = 0.0;
+        for (int trial = 0; trial < 5; ++trial) {
+            auto start = std::chrono::steady_clock::now();
+            for (const std::string& password : passwords) GuessEstimator::log10Guesses(password, words);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (trial == 0 || seconds < fastest) fastest = seconds;
+        }
+        return fastest;
+    }
+
+    // A 4096-character password, the most the daemon accepts, must cost about as much as the same
+    // text estimated in 256-character pieces; quadratic matching would make it 16 times as much.
+    void testLongPasswordsEstimateInLinearTime() {
+        WordMatcher words({ "password", "qwerty", "dragon", "hello" });
+        std::mt19937 rng(1);
+        std::string binary, digits, text;
+        for (int i = 0; i < 4096; ++i) {
+            binary += static_cast<char>('a' + rng() % 2);
+            digits += static_cast<char>('0' + rng() % 10);
+            text += static_cast<char>(33 + rng() % 94);
+        }
+        std::string words_repeated;
+        while (words_repeated.size() < 4096) words_repeated += "password";
+        for (const std::string& password : { std::string(4096, 'a'), words_repeated, binary, digits, text }) {
+            std::vector<std::string> pieces;
+            for (size_t i = 0; i < password.size(); i += 256) pieces.push_back(password.substr(i, 256));
+            double whole = secondsToEstimate({ password }, words);
+            double split = secondsToEstimate(pieces, words);
+            expect(whole < 4.0 * split, password.substr(0, 16) + "...: 4096 characters took " + std::to_string(whole * 1e3) +
+                                        " ms, 16 pieces of 256 took " + std::to_string(split * 1e3) + " ms");
+        }
+    }
+
+    void testRepeatedWordsAreWeak() {
+        ConfigManager config;
+        config.addCommonWord("hello");
+        config.setScoringMode(ScoringMode::GUESSES);
+        PasswordChecker checker(config);
+        for (const char* password : { "passwordpasswordpassword", "hellohellohello", "dragon12dragon12",
+                                      "qwerty123qwerty123" }) {
+            PasswordStrength strength = checker.check(password).getStrength();
+            expect(strength == PasswordStrength::WEAK || strength == PasswordStrength::MEDIUM,
+                   std::string(password) + " scored " + checker.strengthToString(strength));
+        }
+        expect(checker.check("password").getStrength() == PasswordStrength::WEAK, "password is weak");
+        expect(checker.check("passwordpasswordpassword").getStrength() == PasswordStrength::WEAK,
+               "passwordpasswordpassword is weak");
+    }
+
+    // Sorting in runs of a few hundred records forces the merge path.
+    void testBreachCorpusMergedRuns() {
+        const std::string path = "tests_breach_corpus.bin";
+        std::ostringstream passwords;
+        for (int i = 0; i < 5000; ++i) passwords << "password" << (i * 7919) % 3000 << "\n";
+        std::istringstream merged_input(passwords.str());
+        uint64_t records = BreachCorpus::build(merged_input, path, BreachHashType::SHA1, true, 4096);
+        expect(records == 3000, "merged corpus has " + std::to_string(records) + " records, expected 3000");
+        {
+            BreachCorpus corpus(path);
+            expect(corpus.contains("password0") && corpus.contains("password2999"), "merged corpus finds its passwords");
+            expect(!corpus.contains("password3000"), "merged corpus does not find other passwords");
+        }
+
+        std::istringstream single_input(passwords.str());
+        BreachCorpus::build(single_input, path + ".single", BreachHashType::SHA1, true);
+        std::ifstream a(path, std::ios::binary), b(path + ".single", std::ios::binary);
+        std::string merged_bytes((std::istreambuf_iterator<char>(a)), std::istreambuf_iterator<char>());
+        std::string single_bytes((std::istreambuf_iterator<char>(b)), std::istreambuf_iterator<char>());
+        expect(merged_bytes == single_bytes, "merged and in-memory builds write the same corpus");
+        std::remove((path + ".single").c_str());
+
+        // An index entry past the record count would let lookups read beyond the mapping.
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        uint64_t bad = records + 100;
+        file.seekp(64 + 100 * sizeof(uint64_t));
+        file.write(reinterpret_cast<const char*>(&bad), sizeof(bad));
+        file.close();
+        bool rejected = false;
+        try {
+            BreachCorpus corpus(path);
+        }
+        catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        expect(rejected, "corpus with a non-monotonic index is rejected");
+        std::remove(path.c_str());
+    }
+
+    // An image whose word offsets decrease would make getCommonWords read outside the mapping, even
+    // with a checksum that matches.
+    void testConfigImageRejectsBadWordOffsets() {
+        const std::string path = "tests_config_image.pwc";
+        ConfigManager config;
+        config.addCommonWord("alpha");
+        config.addCommonWord("beta");
+        expect(config.compileToFile(path), "configuration image is written");
+
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        std::string image((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        // Header (64 bytes), settings (32 bytes), then 16-byte sections; the word offsets are the 4th.
+        uint64_t offsets_at = 0;
+        std::memcpy(&offsets_at, image.data() + 64 + 32 + 3 * 16, sizeof(offsets_at));
+        uint32_t bad = 0xFFFFFFF0u;
+        std::memcpy(&image[offsets_at + sizeof(uint32_t)], &bad, sizeof(bad));
+        uint64_t checksum = Hash::xxh64(image.data() + 64, image.size() - 64);
+        std::memcpy(&image[24], &checksum, sizeof(checksum));
+        file.seekp(0);
+        file.write(image.data(), static_cast<std::streamsize>(image.size()));
+        file.close();
+
+        ConfigManager loaded;
+        expect(!loaded.loadFromFile(path), "image with decreasing word offsets is rejected");
+        std::remove(path.c_str());
+    }
+
+    // A thread's cached snapshot must not outlive the store's own reference to it.
+    void testConfigStoreReleasesSnapshots() {
+        ConfigStore other;
+        std::weak_ptr<const ConfigManager> replaced;
+        std::weak_ptr<const ConfigManager> orphaned;
+        {
+            ConfigStore store;
+            store.current();
+            replaced = store.snapshot();
+            store.publish(ConfigManager());
+            other.current();
+            expect(replaced.expired(), "a replaced snapshot is released by the next read");
+
+            store.current();
+            orphaned = store.snapshot();
+        }
+        other.current();
+        expect(orphaned.expired(), "the snapshot of a destroyed store is released by the next read");
+
+        other.current();
+        std::weak_ptr<const ConfigManager> idle = other.snapshot();
+        other.publish(ConfigManager());
+        ConfigStore::releaseThreadSnapshots();
+        expect(idle.expired(), "releaseThreadSnapshots drops cached snapshots");
+    }
+
+    // Pool workers go idle after a batch check and must not keep its configuration alive.
+    void testBatchWorkersReleaseSnapshots() {
+        ConfigStore store;
+        PasswordChecker checker(store);
+        ThreadPool pool(4);
+        std::vector<std::string> passwords(8192, "Tr0ub4dor&3");
+        checker.checkBatch(passwords.data(), passwords.size(), pool);
+        std::weak_ptr<const ConfigManager> checked = store.snapshot();
+        store.publish(ConfigManager());
+        store.current();
+        expect(checked.expired(), "the snapshot of a batch check is released once the batch is done");
+    }
+
+    void testConfigStoreStopsWatchingPromptly() {
+        const std::string path = "tests_watch.cfg";
+        std::ofstream(path) << "min_length=8\n";
+        ConfigStore store;
+        store.watchFile(path);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        auto start = std::chrono::steady_clock::now();
+        store.stopWatching();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        expect(elapsed < std::chrono::milliseconds(100), "stopWatching returns without waiting for a poll timeout");
+        std::remove(path.c_str());
+    }
+
+    size_t countOccurrences(const std::string& text, const std::string& needle) {
+        size_t count = 0;
+        for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) ++count;
+        return count;
+    }
+
+    // Each session writes only its own spans, including those of threads that have since exited.
+    void testTraceSessionsStartEmpty() {
+        if constexpr (!Trace::ENABLED) return;
+        for (int session = 0; session < 3; ++session) {
+            Trace::start();
+            for (int i = 0; i < 5000; ++i) Trace::record("main_span", 1, 2);
+            std::thread([] { Trace::record("worker_span", 1, 2); }).join();
+            Trace::stop();
+            std::ostringstream out;
+            Trace::writeChromeJson(out);
+            expect(countOccurrences(out.str(), "\"main_span\"") == 5000,
+                   "session " + std::to_string(session) + " writes this session's main thread spans once");
+            expect(countOccurrences(out.str(), "\"worker_span\"") == 1,
+                   "session " + std::to_string(session) + " writes one worker span");
+        }
+    }
+
+    std::string readFile(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    }
+
+    // Blank lines produce no row, so they must not be counted as checks either.
+    void testAuditMetricsMatchScoredLines(const std::string& audit) {
+        if constexpr (!Metrics::ENABLED) return;
+        const std::string input = "tests_audit_input.txt";
+        const std::string metrics = "tests_audit_metrics.prom";
+        const std::string rows = "tests_audit_rows.csv";
+        std::ofstream(input) << "password\n\nHello123!\nabc\n\n";
+        std::string command = "\"" + audit + "\" --metrics " + metrics + " --output " + rows + " " + input + " 2>"
+#ifdef _WIN32
+                              "NUL";
+#else
+                              "/dev/null";
+#endif
+        expect(std::system(command.c_str()) == 0, "PasswordAudit runs");
+
+        std::istringstream text(readFile(metrics));
+        uint64_t checks = 0;
+        for (std::string line; std::getline(text, line);) {
+            if (line.rfind("password_checker_checks_total{", 0) != 0) continue;
+            checks += std::stoull(line.substr(line.rfind(' ') + 1));
+        }
+        expect(checks == 3, "audit of 3 passwords and 2 blank lines records " + std::to_string(checks) + " checks");
+        std::remove(input.c_str());
+        std::remove(metrics.c_str());
+        std::remove(rows.c_str());
+    }
+}
+
+// With --audit PATH, runs the checks of the PasswordAudit tool at PATH instead of the library checks.
+int main(int argc, char* argv[]) {
+    if (argc == 3 && std::string(argv[1]) == "--audit") {
+        testAuditMetricsMatchScoredLines(argv[2]);
+    } else {
+        testRepeatedTokens();
+        testLongPasswordsEstimateInLinearTime();
+        testRepeatedWordsAreWeak();
+        testBreachCorpusMergedRuns();
+        testConfigImageRejectsBadWordOffsets();
+        testConfigStoreReleasesSnapshots();
+        testBatchWorkersReleaseSnapshots();
+        testConfigStoreStopsWatchingPromptly();
+        testTraceSessionsStartEmpty();
+    }
+    if (failures > 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("All checks passed\n");
+    return 0;
+}
\ No newline at end of file
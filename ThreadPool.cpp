@@ -0,0 +1,105 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t thread_count)
+    : body_(nullptr),
+    count_(0),
+    grain_(1),
+    next_(0),
+    active_workers_(0),
+    generation_(0),
+    stopping_(false) {
+    if (thread_count == 0) thread_count = std::max<size_t>(1, std::thread::hardware_concurrency());
+    workers_.reserve(thread_count - 1);
+    for (size_t i = 1; i < thread_count; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& worker : workers_) worker.join();
+}
+
+size_t ThreadPool::getThreadCount() const {
+    return workers_.size() + 1;
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body) {
+    if (count == 0) return;
+    if (grain == 0) grain = 1;
+
+    if (workers_.empty() || count <= grain) {
+        body(0, count);
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit_lock(submit_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        body_ = &body;
+        count_ = count;
+        grain_ = grain;
+        next_.store(0, std::memory_order_relaxed);
+        active_workers_ = workers_.size();
+        error_ = nullptr;
+        ++generation_;
+    }
+    work_cv_.notify_all();
+
+    runChunks();
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [this] { return active_workers_ == 0; });
+        body_ = nullptr;
+        error = error_;
+        error_ = nullptr;
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::workerLoop() {
+    uint64_t seen_generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [&] { return stopping_ || generation_ != seen_generation; });
+            if (stopping_) return;
+            seen_generation = generation_;
+        }
+
+        runChunks();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--active_workers_ == 0) done_cv_.notify_one();
+        }
+    }
+}
+
+void ThreadPool::runChunks() {
+    while (true) {
+        size_t begin = next_.fetch_add(grain_, std::memory_order_relaxed);
+        if (begin >= count_) return;
+        size_t end = std::min(count_, begin + grain_);
+        try {
+            (*body_)(begin, end);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) error_ = std::current_exception();
+            next_.store(count_, std::memory_order_relaxed);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    // thread_count counts the calling thread, which always takes part in parallelFor.
+    explicit ThreadPool(size_t thread_count = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t getThreadCount() const;
+
+    // Splits [0, count) into chunks of at most grain items and runs body(begin, end) on every
+    // thread of the pool until all chunks are done. The first exception thrown is rethrown here.
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body);
+
+    static ThreadPool& shared();
+
+private:
+    std::vector<std::thread> workers_;
+    std::mutex submit_mutex_;
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+
+    const std::function<void(size_t, size_t)>* body_;
+    size_t count_;
+    size_t grain_;
+    std::atomic<size_t> next_;
+    size_t active_workers_;
+    uint64_t generation_;
+    bool stopping_;
+    std::exception_ptr error_;
+
+    void workerLoop();
+    void runChunks();
+};
+
+#endif
\ No newline at end of file
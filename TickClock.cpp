@@ -0,0 +1,32 @@
+#include "TickClock.hpp"
+#include <thread>
+
+namespace {
+    struct ClockOrigin {
+        std::chrono::steady_clock::time_point time;
+        uint64_t ticks;
+    };
+
+    const ClockOrigin clock_origin = { std::chrono::steady_clock::now(), TickClock::now() };
+}
+
+namespace TickClock {
+    double secondsPerTick() {
+#ifdef TICK_CLOCK_TSC
+        // A short baseline would make the estimate noisy; early callers wait for a usable one.
+        auto minimum = std::chrono::milliseconds(20);
+        auto elapsed = std::chrono::steady_clock::now() - clock_origin.time;
+        if (elapsed < minimum) std::this_thread::sleep_for(minimum - elapsed);
+        auto time = std::chrono::steady_clock::now();
+        uint64_t ticks = now();
+        double seconds = std::chrono::duration<double>(time - clock_origin.time).count();
+        return ticks > clock_origin.ticks ? seconds / static_cast<double>(ticks - clock_origin.ticks) : 0.0;
+#else
+        return 1e-9;
+#endif
+    }
+
+    uint64_t origin() {
+        return clock_origin.ticks;
+    }
+}
\ No newline at end of file
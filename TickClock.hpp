@@ -0,0 +1,34 @@
+#ifndef TICK_CLOCK_HPP
+#define TICK_CLOCK_HPP
+#include <chrono>
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#if defined(_MSC_VER) && defined(_M_X64)
+#define TICK_CLOCK_TSC 1
+#elif defined(__x86_64__)
+#include <x86intrin.h>
+#define TICK_CLOCK_TSC 1
+#endif
+
+// The cheapest monotonic clock available: the TSC on x86-64, steady_clock nanoseconds elsewhere.
+// Ticks are only meaningful as differences; secondsPerTick() converts them.
+namespace TickClock {
+    inline uint64_t now() {
+#ifdef TICK_CLOCK_TSC
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    // Length of one tick in seconds, measured against steady_clock since the process started.
+    double secondsPerTick();
+    // Tick count at process start, the zero point for absolute timestamps.
+    uint64_t origin();
+}
+
+#endif
\ No newline at end of file
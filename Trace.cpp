@@ -0,0 +1,202 @@
+#include "Trace.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+    constexpr uint32_t CHUNK_EVENTS = 4096;
+
+    struct Event {
+        const char* name;
+        uint64_t start;
+        uint64_t end;
+    };
+
+    // Only the owning thread appends; count is published with a release store so a concurrent
+    // writeChromeJson sees whole events.
+    struct Chunk {
+        Event events[CHUNK_EVENTS];
+        std::atomic<uint32_t> count{ 0 };
+        std::atomic<Chunk*> next{ nullptr };
+    };
+
+    // The chunks of a buffer belong to the trace session it last recorded in. When its thread
+    // records in a later session it empties them under the registry lock and fills them again, so
+    // a buffer holds at most one session's spans and never grows past what one session needed.
+    struct ThreadBuffer {
+        uint32_t tid = 0;
+        std::atomic<Chunk*> head{ nullptr };
+        Chunk* tail = nullptr;
+        size_t recorded = 0;
+        uint64_t session = 0;
+        bool exited = false;
+
+        ~ThreadBuffer() {
+            Chunk* chunk = head.load(std::memory_order_relaxed);
+            while (chunk) {
+                Chunk* next = chunk->next.load(std::memory_order_relaxed);
+                delete chunk;
+                chunk = next;
+            }
+        }
+    };
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+        uint32_t next_tid = 1;
+        std::atomic<uint64_t> session{ 0 };
+        std::atomic<size_t> max_events{ 0 };
+        std::atomic<uint64_t> dropped{ 0 };
+    };
+
+    // Never destroyed: spans of threads that have exited are still written out, and threads that
+    // outlive static destruction can still record.
+    Registry& registry() {
+        static Registry* instance = new Registry();
+        return *instance;
+    }
+
+    // Marks the thread's buffer as exited so the next start() can free it once it has been written.
+    struct BufferOwner {
+        ThreadBuffer* buffer = nullptr;
+
+        ~BufferOwner() {
+            if (!buffer) return;
+            std::lock_guard<std::mutex> lock(registry().mutex);
+            buffer->exited = true;
+        }
+    };
+
+    thread_local BufferOwner current_buffer;
+
+    ThreadBuffer& threadBuffer(Registry& shared) {
+        uint64_t session = shared.session.load(std::memory_order_acquire);
+        ThreadBuffer* buffer = current_buffer.buffer;
+        if (buffer && buffer->session == session) return *buffer;
+
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        if (!buffer) {
+            shared.buffers.push_back(std::make_unique<ThreadBuffer>());
+            buffer = shared.buffers.back().get();
+            buffer->tid = shared.next_tid++;
+            current_buffer.buffer = buffer;
+        }
+        Chunk* first = buffer->head.load(std::memory_order_relaxed);
+        for (Chunk* chunk = first; chunk; chunk = chunk->next.load(std::memory_order_relaxed)) {
+            chunk->count.store(0, std::memory_order_relaxed);
+        }
+        buffer->tail = first;
+        buffer->recorded = 0;
+        buffer->session = shared.session.load(std::memory_order_relaxed);
+        return *buffer;
+    }
+
+    void appendJsonString(std::string& out, const char* text) {
+        out += '"';
+        for (const char* p = text; *p; ++p) {
+            if (*p == '"' || *p == '\\') out += '\\';
+            if (static_cast<unsigned char>(*p) >= 0x20) out += *p;
+        }
+        out += '"';
+    }
+}
+
+namespace Trace {
+    void start(size_t max_events_per_thread) {
+        Registry& shared = registry();
+        {
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            auto& buffers = shared.buffers;
+            buffers.erase(std::remove_if(buffers.begin(), buffers.end(),
+                                         [](const std::unique_ptr<ThreadBuffer>& buffer) { return buffer->exited; }),
+                          buffers.end());
+            shared.session.fetch_add(1, std::memory_order_release);
+            shared.dropped.store(0, std::memory_order_relaxed);
+        }
+        shared.max_events.store(max_events_per_thread, std::memory_order_relaxed);
+        active.store(true, std::memory_order_relaxed);
+    }
+
+    void stop() {
+        active.store(false, std::memory_order_relaxed);
+    }
+
+    void record(const char* name, uint64_t start_ticks, uint64_t end_ticks) {
+        Registry& shared = registry();
+        ThreadBuffer& buffer = threadBuffer(shared);
+        if (buffer.recorded >= shared.max_events.load(std::memory_order_relaxed)) {
+            shared.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        Chunk* chunk = buffer.tail;
+        uint32_t count = chunk ? chunk->count.load(std::memory_order_relaxed) : CHUNK_EVENTS;
+        if (count == CHUNK_EVENTS) {
+            Chunk* next = chunk ? chunk->next.load(std::memory_order_relaxed) : buffer.head.load(std::memory_order_relaxed);
+            if (!next) {
+                next = new Chunk;
+                if (chunk) chunk->next.store(next, std::memory_order_release);
+                else buffer.head.store(next, std::memory_order_release);
+            }
+            buffer.tail = next;
+            chunk = next;
+            count = 0;
+        }
+        chunk->events[count] = { name, start_ticks, end_ticks };
+        chunk->count.store(count + 1, std::memory_order_release);
+        ++buffer.recorded;
+    }
+
+    uint64_t getDroppedCount() {
+        return registry().dropped.load(std::memory_order_relaxed);
+    }
+
+    void writeChromeJson(std::ostream& out) {
+        double micros_per_tick = TickClock::secondsPerTick() * 1e6;
+        uint64_t origin = TickClock::origin();
+        std::string text = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        char numbers[96];
+
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        uint64_t session = shared.session.load(std::memory_order_relaxed);
+        for (const auto& buffer : shared.buffers) {
+            if (buffer->session != session) continue;
+            for (const Chunk* chunk = buffer->head.load(std::memory_order_acquire); chunk;
+                 chunk = chunk->next.load(std::memory_order_acquire)) {
+                uint32_t count = chunk->count.load(std::memory_order_acquire);
+                for (uint32_t i = 0; i < count; ++i) {
+                    const Event& event = chunk->events[i];
+                    // Another core's TSC may trail slightly; keep timestamps and durations non-negative.
+                    uint64_t start = event.start > origin ? event.start - origin : 0;
+                    uint64_t duration = event.end > event.start ? event.end - event.start : 0;
+                    text += first ? "\n" : ",\n";
+                    first = false;
+                    text += "{\"name\":";
+                    appendJsonString(text, event.name);
+                    std::snprintf(numbers, sizeof(numbers), ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                                  buffer->tid, start * micros_per_tick, duration * micros_per_tick);
+                    text += numbers;
+                }
+                if (text.size() >= (size_t(1) << 20)) {
+                    out << text;
+                    text.clear();
+                }
+            }
+        }
+        text += "\n]}\n";
+        out << text;
+    }
+
+    bool writeFile(const std::string& filename) {
+        std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        writeChromeJson(out);
+        return static_cast<bool>(out);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include "TickClock.hpp"
+
+// Set to 0 (CMake: -DPASSWORD_CHECKER_ENABLE_TRACING=OFF) and spans compile to nothing.
+#ifndef PASSWORD_CHECKER_TRACING
+#define PASSWORD_CHECKER_TRACING 1
+#endif
+
+// Scoped trace spans around the stages of a check, written out in the Chrome trace event format
+// (chrome://tracing, ui.perfetto.dev).
+//
+// Tracing is off until start() is called; until then a span costs one relaxed load. While on,
+// each thread appends to a buffer of its own, so recording never locks. Buffers stop growing at
+// the per-thread limit given to start() and later spans are counted as dropped. The spans stay
+// available for writing after stop(); the next start() discards them and the buffers are reused.
+namespace Trace {
+    constexpr bool ENABLED = PASSWORD_CHECKER_TRACING != 0;
+
+    inline std::atomic<bool> active{ false };
+
+    inline bool isActive() {
+        if constexpr (ENABLED) return active.load(std::memory_order_relaxed);
+        else return false;
+    }
+
+    void start(size_t max_events_per_thread = size_t(1) << 20);
+    void stop();
+
+    // name must outlive the trace; string literals are the intended use.
+    void record(const char* name, uint64_t start_ticks, uint64_t end_ticks);
+
+    uint64_t getDroppedCount();
+    // Writes every span recorded so far. Spans recorded while this runs may or may not be included.
+    void writeChromeJson(std::ostream& out);
+    bool writeFile(const std::string& filename);
+
+    class Span {
+    public:
+        explicit Span(const char* name) {
+            if constexpr (ENABLED) {
+                if (isActive()) {
+                    name_ = name;
+                    start_ = TickClock::now();
+                }
+            }
+        }
+
+        ~Span() {
+            if constexpr (ENABLED) {
+                if (name_) record(name_, start_, TickClock::now());
+            }
+        }
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+    private:
+        const char* name_ = nullptr;
+        uint64_t start_ = 0;
+    };
+}
+
+#endif
\ No newline at end of file
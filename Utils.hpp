@@ -1,32 +1,35 @@
-#ifndef UTILS_HPP
-#define UTILS_HPP
-#include <string>
-#include <vector>
-#include <random>
-
-namespace Utils {
-    std::string toLower(const std::string& str);
-    std::string toUpper(const std::string& str);
-    std::string trim(const std::string& str);
-    std::vector<std::string> split(const std::string& str, char delimiter);
-    bool startsWith(const std::string& str, const std::string& prefix);
-    bool endsWith(const std::string& str, const std::string& suffix);
-    
-    std::string generateRandomPassword(size_t length, bool includeUpper = true,
-                                     bool includeLower = true, bool includeDigits = true,
-                                     bool includeSpecial = true);
-    double calculatePasswordEntropy(const std::string& password);
-    bool isCommonPassword(const std::string& password,
-                         const std::vector<std::string>& commonWords);
-    
-    bool containsUpperCase(const std::string& str);
-    bool containsLowerCase(const std::string& str);
-    bool containsDigit(const std::string& str);
-    bool containsSpecialChar(const std::string& str);
-    bool isSequential(const std::string& str);
-    
-    int getRandomInt(int min, int max);
-    char getRandomChar(const std::string& charset);
-}
-
+#ifndef UTILS_HPP
+#define UTILS_HPP
+#include <string>
+#include <string_view>
+#include <vector>
+#include <random>
+
+namespace Utils {
+    std::string toLower(std::string_view str);
+    std::string toUpper(std::string_view str);
+    std::string trim(std::string_view str);
+    std::vector<std::string> split(std::string_view str, char delimiter);
+    bool startsWith(std::string_view str, std::string_view prefix);
+    bool endsWith(std::string_view str, std::string_view suffix);
+    // ASCII case-insensitive substring search, without copying either string.
+    bool containsIgnoreCase(std::string_view text, std::string_view needle);
+    
+    std::string generateRandomPassword(size_t length, bool includeUpper = true,
+                                     bool includeLower = true, bool includeDigits = true,
+                                     bool includeSpecial = true);
+    double calculatePasswordEntropy(std::string_view password);
+    bool isCommonPassword(std::string_view password,
+                         const std::vector<std::string>& commonWords);
+    
+    bool containsUpperCase(std::string_view str);
+    bool containsLowerCase(std::string_view str);
+    bool containsDigit(std::string_view str);
+    bool containsSpecialChar(std::string_view str);
+    bool isSequential(std::string_view str);
+    
+    int getRandomInt(int min, int max);
+    char getRandomChar(std::string_view charset);
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,461 @@
+#include "WordList.hpp"
+#include "Hash.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+
+#ifdef PASSWORD_CHECKER_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef PASSWORD_CHECKER_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+    constexpr size_t CHUNK_BYTES = size_t(4) << 20;
+    constexpr size_t MIN_SLICE_BYTES = size_t(64) << 10;
+    constexpr unsigned SHARD_BITS = 6;
+    constexpr size_t SHARD_COUNT = size_t(1) << SHARD_BITS;
+    constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+    constexpr uint32_t PENDING = uint32_t(1) << 31;
+    constexpr uint32_t DUPLICATE = UINT32_MAX;
+
+    class ByteSource {
+    public:
+        virtual ~ByteSource() = default;
+        // Fills up to size bytes and returns how many were written; 0 means the input has ended.
+        virtual size_t read(char* out, size_t size) = 0;
+    };
+
+    class FileSource : public ByteSource {
+    public:
+        explicit FileSource(const std::string& filename)
+            : filename_(filename),
+            file_(std::fopen(filename.c_str(), "rb")) {
+            if (file_ == nullptr) throw std::runtime_error("Failed to open word list: " + filename);
+        }
+
+        ~FileSource() override {
+            std::fclose(file_);
+        }
+
+        size_t read(char* out, size_t size) override {
+            size_t count = std::fread(out, 1, size, file_);
+            if (count < size && std::ferror(file_)) throw std::runtime_error("Failed to read word list: " + filename_);
+            return count;
+        }
+
+    private:
+        std::string filename_;
+        std::FILE* file_;
+    };
+
+#ifdef PASSWORD_CHECKER_HAVE_ZLIB
+    class GzipSource : public ByteSource {
+    public:
+        explicit GzipSource(const std::string& filename)
+            : filename_(filename),
+            file_(gzopen(filename.c_str(), "rb")) {
+            if (file_ == nullptr) throw std::runtime_error("Failed to open word list: " + filename);
+            gzbuffer(file_, 256 * 1024);
+        }
+
+        ~GzipSource() override {
+            gzclose(file_);
+        }
+
+        size_t read(char* out, size_t size) override {
+            int count = gzread(file_, out, static_cast<unsigned>(std::min<size_t>(size, INT_MAX)));
+            int code = Z_OK;
+            const char* message = gzerror(file_, &code);
+            // A truncated stream ends with a short read and Z_BUF_ERROR rather than a failed read.
+            if (count < 0 || (code != Z_OK && code != Z_STREAM_END)) {
+                throw std::runtime_error("Failed to decompress word list " + filename_ + ": " + message);
+            }
+            return static_cast<size_t>(count);
+        }
+
+    private:
+        std::string filename_;
+        gzFile file_;
+    };
+#endif
+
+#ifdef PASSWORD_CHECKER_HAVE_ZSTD
+    class ZstdSource : public ByteSource {
+    public:
+        explicit ZstdSource(const std::string& filename)
+            : filename_(filename),
+            input_(filename),
+            stream_(ZSTD_createDStream()),
+            buffer_(ZSTD_DStreamInSize()),
+            in_{ buffer_.data(), 0, 0 } {
+            if (stream_ == nullptr) throw std::bad_alloc();
+            ZSTD_initDStream(stream_);
+        }
+
+        ~ZstdSource() override {
+            ZSTD_freeDStream(stream_);
+        }
+
+        size_t read(char* out, size_t size) override {
+            ZSTD_outBuffer output = { out, size, 0 };
+            while (output.pos < output.size) {
+                if (in_.pos == in_.size && !input_done_) {
+                    in_.size = input_.read(buffer_.data(), buffer_.size());
+                    in_.pos = 0;
+                    input_done_ = in_.size == 0;
+                }
+                size_t in_before = in_.pos;
+                size_t out_before = output.pos;
+                size_t result = ZSTD_decompressStream(stream_, &output, &in_);
+                if (ZSTD_isError(result)) {
+                    throw std::runtime_error("Failed to decompress word list " + filename_ + ": " + ZSTD_getErrorName(result));
+                }
+                if (in_.pos != in_before || output.pos != out_before) {
+                    frame_done_ = result == 0;
+                } else if (input_done_) {
+                    if (!frame_done_) throw std::runtime_error("Truncated word list: " + filename_);
+                    break;
+                }
+            }
+            return output.pos;
+        }
+
+    private:
+        std::string filename_;
+        FileSource input_;
+        ZSTD_DStream* stream_;
+        std::vector<char> buffer_;
+        ZSTD_inBuffer in_;
+        bool input_done_ = false;
+        bool frame_done_ = false;
+    };
+#endif
+
+    std::unique_ptr<ByteSource> openSource(const std::string& filename) {
+        switch (WordList::detectCompression(filename)) {
+        case WordList::Compression::GZIP:
+#ifdef PASSWORD_CHECKER_HAVE_ZLIB
+            return std::make_unique<GzipSource>(filename);
+#else
+            throw std::runtime_error("Word list is gzip-compressed, but this build has no zlib support: " + filename);
+#endif
+        case WordList::Compression::ZSTD:
+#ifdef PASSWORD_CHECKER_HAVE_ZSTD
+            return std::make_unique<ZstdSource>(filename);
+#else
+            throw std::runtime_error("Word list is zstd-compressed, but this build has no zstd support: " + filename);
+#endif
+        default:
+            return std::make_unique<FileSource>(filename);
+        }
+    }
+
+    inline bool isBlank(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    inline char foldCase(char c) {
+        return c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+
+    inline size_t shardOf(uint64_t hash) {
+        return static_cast<size_t>(hash >> (64 - SHARD_BITS));
+    }
+
+    struct Record {
+        uint32_t offset;
+        uint32_t length;
+        uint64_t hash;
+    };
+
+    // Trims and case-folds the lines of data[begin, end) in place and records where each word is.
+    void parseSlice(char* data, size_t begin, size_t end, std::vector<Record>& records) {
+        records.clear();
+        size_t pos = begin;
+        while (pos < end) {
+            const void* newline = std::memchr(data + pos, '\n', end - pos);
+            size_t line_end = newline ? static_cast<size_t>(static_cast<const char*>(newline) - data) : end;
+            size_t first = pos;
+            size_t last = line_end;
+            while (first < last && isBlank(data[first])) ++first;
+            while (last > first && isBlank(data[last - 1])) --last;
+            if (last > first) {
+                for (size_t i = first; i < last; ++i) data[i] = foldCase(data[i]);
+                records.push_back({ static_cast<uint32_t>(first), static_cast<uint32_t>(last - first),
+                                    Hash::xxh64(data + first, last - first) });
+            }
+            pos = line_end + 1;
+        }
+    }
+
+    // Deduplicates chunks of lines against the word vector and each other. Words are split into
+    // shards by hash so every shard's table can be updated on its own thread. Table entries hold
+    // 32-bit ids instead of strings: ids below PENDING index the word vector, PENDING | r is
+    // record r of the chunk in progress until its final position is known.
+    class Importer {
+    public:
+        Importer(std::vector<std::string>& words, ThreadPool& pool)
+            : words_(words),
+            pool_(pool),
+            shards_(SHARD_COUNT),
+            chunk_(nullptr) {
+            size_t count = words_.size();
+            if (count >= PENDING) throw std::length_error("Word list is too large to import into");
+
+            std::vector<uint64_t> hashes(count);
+            pool_.parallelFor(count, 4096, [this, &hashes](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) hashes[i] = Hash::xxh64(words_[i].data(), words_[i].size());
+            });
+
+            std::vector<uint32_t> order;
+            std::vector<size_t> shard_begin;
+            groupByShard(count, [&hashes](size_t i) { return hashes[i]; }, order, shard_begin);
+            pool_.parallelFor(SHARD_COUNT, 1, [&](size_t begin, size_t end) {
+                for (size_t s = begin; s < end; ++s) {
+                    Shard& shard = shards_[s];
+                    size_t slots = 16;
+                    while (slots < 2 * (shard_begin[s + 1] - shard_begin[s]) + 2) slots *= 2;
+                    shard.slots.assign(slots, { 0, EMPTY_SLOT });
+                    for (size_t k = shard_begin[s]; k < shard_begin[s + 1]; ++k) {
+                        uint32_t id = order[k];
+                        const std::string& word = words_[id];
+                        insert(shard, static_cast<uint32_t>(hashes[id]), word.data(), word.size(), id);
+                    }
+                }
+            });
+        }
+
+        // data[0, size) holds whole lines. Returns how many new words were appended.
+        size_t addLines(char* data, size_t size) {
+            if (size == 0) return 0;
+            chunk_ = data;
+
+            // Slices end on line boundaries so each thread parses whole lines.
+            size_t slice_count = std::max<size_t>(1, std::min(size / MIN_SLICE_BYTES, pool_.getThreadCount() * 4));
+            std::vector<size_t> bounds(slice_count + 1, size);
+            bounds[0] = 0;
+            for (size_t k = 1; k < slice_count; ++k) {
+                size_t target = std::max(bounds[k - 1], size / slice_count * k);
+                const void* newline = std::memchr(data + target, '\n', size - target);
+                bounds[k] = newline ? static_cast<size_t>(static_cast<const char*>(newline) - data) + 1 : size;
+            }
+            slice_records_.resize(slice_count);
+            pool_.parallelFor(slice_count, 1, [&](size_t begin, size_t end) {
+                for (size_t p = begin; p < end; ++p) parseSlice(data, bounds[p], bounds[p + 1], slice_records_[p]);
+            });
+
+            std::vector<size_t> slice_base(slice_count + 1, 0);
+            for (size_t p = 0; p < slice_count; ++p) slice_base[p + 1] = slice_base[p] + slice_records_[p].size();
+            size_t record_count = slice_base[slice_count];
+            records_.resize(record_count);
+            final_index_.assign(record_count, 0);
+            pool_.parallelFor(slice_count, 1, [&](size_t begin, size_t end) {
+                for (size_t p = begin; p < end; ++p) {
+                    std::copy(slice_records_[p].begin(), slice_records_[p].end(), records_.begin() + slice_base[p]);
+                }
+            });
+
+            // Records keep their file order within each shard, so the first occurrence of a word wins.
+            groupByShard(record_count, [this](size_t r) { return records_[r].hash; }, order_, shard_begin_);
+            pool_.parallelFor(SHARD_COUNT, 1, [this](size_t begin, size_t end) {
+                for (size_t s = begin; s < end; ++s) {
+                    Shard& shard = shards_[s];
+                    for (size_t k = shard_begin_[s]; k < shard_begin_[s + 1]; ++k) {
+                        uint32_t r = order_[k];
+                        const Record& record = records_[r];
+                        if (insert(shard, static_cast<uint32_t>(record.hash), chunk_ + record.offset, record.length, PENDING | r)) {
+                            shard.pending.push_back(r);
+                        } else {
+                            final_index_[r] = DUPLICATE;
+                        }
+                    }
+                }
+            });
+
+            std::vector<size_t> slice_start(slice_count + 1, words_.size());
+            pool_.parallelFor(slice_count, 1, [&](size_t begin, size_t end) {
+                for (size_t p = begin; p < end; ++p) {
+                    slice_start[p + 1] = static_cast<size_t>(std::count_if(
+                        final_index_.begin() + slice_base[p], final_index_.begin() + slice_base[p + 1],
+                        [](uint32_t index) { return index != DUPLICATE; }));
+                }
+            });
+            for (size_t p = 0; p < slice_count; ++p) slice_start[p + 1] += slice_start[p];
+            size_t added = slice_start[slice_count] - words_.size();
+            if (slice_start[slice_count] >= PENDING) throw std::length_error("Word list is too large to import");
+
+            words_.resize(slice_start[slice_count]);
+            pool_.parallelFor(slice_count, 1, [&](size_t begin, size_t end) {
+                for (size_t p = begin; p < end; ++p) {
+                    size_t index = slice_start[p];
+                    for (size_t r = slice_base[p]; r < slice_base[p + 1]; ++r) {
+                        if (final_index_[r] == DUPLICATE) continue;
+                        final_index_[r] = static_cast<uint32_t>(index);
+                        words_[index++].assign(chunk_ + records_[r].offset, records_[r].length);
+                    }
+                }
+            });
+            pool_.parallelFor(SHARD_COUNT, 1, [this](size_t begin, size_t end) {
+                for (size_t s = begin; s < end; ++s) resolvePending(shards_[s]);
+            });
+            return added;
+        }
+
+    private:
+        struct Slot {
+            uint32_t tag;
+            uint32_t id;
+        };
+
+        struct Shard {
+            std::vector<Slot> slots;
+            size_t used = 0;
+            std::vector<uint32_t> pending;
+        };
+
+        std::vector<std::string>& words_;
+        ThreadPool& pool_;
+        std::vector<Shard> shards_;
+        const char* chunk_;
+        std::vector<std::vector<Record>> slice_records_;
+        std::vector<Record> records_;
+        std::vector<uint32_t> final_index_;
+        std::vector<uint32_t> order_;
+        std::vector<size_t> shard_begin_;
+
+        // Stable counting sort of [0, count) by shard.
+        template <typename HashOf>
+        static void groupByShard(size_t count, HashOf hash_of, std::vector<uint32_t>& order, std::vector<size_t>& shard_begin) {
+            shard_begin.assign(SHARD_COUNT + 1, 0);
+            for (size_t i = 0; i < count; ++i) ++shard_begin[shardOf(hash_of(i)) + 1];
+            for (size_t s = 0; s < SHARD_COUNT; ++s) shard_begin[s + 1] += shard_begin[s];
+            std::vector<size_t> cursor(shard_begin.begin(), shard_begin.end() - 1);
+            order.resize(count);
+            for (size_t i = 0; i < count; ++i) order[cursor[shardOf(hash_of(i))]++] = static_cast<uint32_t>(i);
+        }
+
+        bool sameWord(uint32_t id, const char* text, size_t length) const {
+            if (id & PENDING) {
+                const Record& record = records_[id & ~PENDING];
+                return record.length == length && std::memcmp(chunk_ + record.offset, text, length) == 0;
+            }
+            const std::string& word = words_[id];
+            return word.size() == length && std::memcmp(word.data(), text, length) == 0;
+        }
+
+        // Returns false, leaving the table unchanged, when the word is already present.
+        bool insert(Shard& shard, uint32_t tag, const char* text, size_t length, uint32_t id) {
+            if ((shard.used + 1) * 2 > shard.slots.size()) grow(shard);
+            size_t mask = shard.slots.size() - 1;
+            for (size_t i = tag & mask;; i = (i + 1) & mask) {
+                Slot& slot = shard.slots[i];
+                if (slot.id == EMPTY_SLOT) {
+                    slot = { tag, id };
+                    ++shard.used;
+                    return true;
+                }
+                if (slot.tag == tag && sameWord(slot.id, text, length)) return false;
+            }
+        }
+
+        static void grow(Shard& shard) {
+            std::vector<Slot> old(std::max<size_t>(16, shard.slots.size() * 2), Slot{ 0, EMPTY_SLOT });
+            old.swap(shard.slots);
+            size_t mask = shard.slots.size() - 1;
+            for (const Slot& slot : old) {
+                if (slot.id == EMPTY_SLOT) continue;
+                size_t i = slot.tag & mask;
+                while (shard.slots[i].id != EMPTY_SLOT) i = (i + 1) & mask;
+                shard.slots[i] = slot;
+            }
+        }
+
+        void resolvePending(Shard& shard) {
+            size_t mask = shard.slots.size() - 1;
+            for (uint32_t r : shard.pending) {
+                size_t i = static_cast<uint32_t>(records_[r].hash) & mask;
+                while (shard.slots[i].id != (PENDING | r)) i = (i + 1) & mask;
+                shard.slots[i].id = final_index_[r];
+            }
+            shard.pending.clear();
+        }
+    };
+}
+
+namespace WordList {
+    Compression detectCompression(const std::string& filename) {
+        unsigned char magic[4] = {};
+        std::FILE* file = std::fopen(filename.c_str(), "rb");
+        if (file == nullptr) throw std::runtime_error("Failed to open word list: " + filename);
+        size_t count = std::fread(magic, 1, sizeof(magic), file);
+        std::fclose(file);
+
+        if (count >= 2 && magic[0] == 0x1F && magic[1] == 0x8B) return Compression::GZIP;
+        if (count >= 4 && magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD) return Compression::ZSTD;
+        return Compression::NONE;
+    }
+
+    bool isSupported(Compression compression) {
+        switch (compression) {
+        case Compression::GZIP:
+#ifdef PASSWORD_CHECKER_HAVE_ZLIB
+            return true;
+#else
+            return false;
+#endif
+        case Compression::ZSTD:
+#ifdef PASSWORD_CHECKER_HAVE_ZSTD
+            return true;
+#else
+            return false;
+#endif
+        default:
+            return true;
+        }
+    }
+
+    size_t import(const std::string& filename, std::vector<std::string>& words, ThreadPool& pool) {
+        std::unique_ptr<ByteSource> source = openSource(filename);
+        Importer importer(words, pool);
+
+        std::vector<char> buffer(CHUNK_BYTES);
+        size_t filled = 0;
+        size_t added = 0;
+        bool at_start = true;
+        bool at_end = false;
+        while (!at_end) {
+            size_t count = source->read(buffer.data() + filled, buffer.size() - filled);
+            filled += count;
+            at_end = count == 0;
+            if (!at_end && filled < buffer.size()) continue;
+
+            // Hand over whole lines only; the partial last line moves to the front of the buffer.
+            size_t cut = filled;
+            if (!at_end) {
+                while (cut > 0 && buffer[cut - 1] != '\n') --cut;
+                if (cut == 0) {
+                    if (buffer.size() > UINT32_MAX / 2) throw std::length_error("Line too long in word list: " + filename);
+                    buffer.resize(buffer.size() * 2);
+                    continue;
+                }
+            }
+            size_t skip = 0;
+            if (at_start) {
+                at_start = false;
+                if (cut >= 3 && std::memcmp(buffer.data(), "\xEF\xBB\xBF", 3) == 0) skip = 3;
+            }
+            added += importer.addLines(buffer.data() + skip, cut - skip);
+            std::memmove(buffer.data(), buffer.data() + cut, filled - cut);
+            filled -= cut;
+        }
+        return added;
+    }
+}
\ No newline at end of file
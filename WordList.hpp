@@ -0,0 +1,30 @@
+#ifndef WORD_LIST_HPP
+#define WORD_LIST_HPP
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+// Word list files: one word per line, stored as plain text, gzip or zstd. The format is detected
+// from the first bytes of the file, not its name.
+namespace WordList {
+    enum class Compression {
+        NONE,
+        GZIP,
+        ZSTD
+    };
+
+    Compression detectCompression(const std::string& filename);
+    // Compressed formats need zlib or libzstd at build time.
+    bool isSupported(Compression compression);
+
+    // Appends the words of filename that words does not already contain, in file order, and
+    // returns how many were added. Lines are trimmed of surrounding whitespace and ASCII
+    // case-folded; blank lines are skipped. The file is read in fixed-size chunks, each normalized
+    // and deduplicated on the pool's threads, so memory stays close to the size of words itself.
+    // Throws std::runtime_error if the file cannot be read or decompressed.
+    size_t import(const std::string& filename, std::vector<std::string>& words, ThreadPool& pool);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,321 @@
+#include "WordMatcher.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    constexpr std::array<unsigned char, 256> makeFoldTable() {
+        std::array<unsigned char, 256> table{};
+        for (int c = 0; c < 256; ++c) {
+            table[c] = static_cast<unsigned char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+        }
+        return table;
+    }
+
+    constexpr std::array<unsigned char, 256> kFoldTable = makeFoldTable();
+    constexpr uint32_t NO_EDGE = UINT32_MAX;
+    // Shallow states get a full transition row, as long as the rows fit in this many entries.
+    constexpr size_t DENSE_TABLE_BUDGET = size_t(1) << 20;
+    constexpr size_t IMAGE_ALIGNMENT = 8;
+
+    struct ImageHeader {
+        uint32_t class_count;
+        uint32_t dense_states;
+        uint64_t state_count;
+        uint64_t edge_count;
+        uint64_t word_count;
+        uint64_t word_bytes;
+        uint8_t char_class[256];
+    };
+    static_assert(sizeof(ImageHeader) % IMAGE_ALIGNMENT == 0, "Matcher image header must keep arrays aligned");
+
+    size_t alignImage(size_t offset) {
+        return (offset + IMAGE_ALIGNMENT - 1) & ~(IMAGE_ALIGNMENT - 1);
+    }
+}
+
+struct WordMatcher::Storage {
+    std::vector<uint32_t> dense_next;
+    std::vector<uint32_t> edge_begin;
+    std::vector<uint8_t> edge_label;
+    std::vector<uint32_t> edge_target;
+    std::vector<uint32_t> fail;
+    std::vector<uint32_t> word_at;
+    std::vector<uint32_t> output_link;
+    std::vector<uint32_t> word_offsets;
+    std::string word_chars;
+};
+
+WordMatcher::WordMatcher() : WordMatcher(std::vector<std::string>()) {
+}
+
+WordMatcher::WordMatcher(const std::vector<std::string>& words) : char_class_{} {
+    struct TrieNode {
+        std::vector<std::pair<uint8_t, uint32_t>> children;
+        uint32_t word = NO_WORD;
+    };
+
+    auto storage = std::make_shared<Storage>();
+    auto& word_offsets = storage->word_offsets;
+    auto& word_chars = storage->word_chars;
+    auto& edge_begin = storage->edge_begin;
+    auto& edge_label = storage->edge_label;
+    auto& edge_target = storage->edge_target;
+    auto& fail = storage->fail;
+    auto& word_at = storage->word_at;
+    auto& output_link = storage->output_link;
+    auto& dense_next = storage->dense_next;
+
+    // Bytes that occur in no word all map to class 0, which always sends the automaton back to the
+    // root; the rest get compact class ids so transition rows stay small.
+    bool used[256] = {};
+    for (const auto& word : words) {
+        for (char ch : word) used[kFoldTable[static_cast<unsigned char>(ch)]] = true;
+    }
+    uint8_t folded_class[256] = {};
+    class_count_ = 1;
+    for (int c = 0; c < 256; ++c) {
+        if (used[c]) folded_class[c] = static_cast<uint8_t>(class_count_++);
+    }
+    for (int c = 0; c < 256; ++c) char_class_[c] = folded_class[kFoldTable[c]];
+
+    std::vector<TrieNode> trie(1);
+    word_offsets.push_back(0);
+    for (const auto& word : words) {
+        if (word.empty()) continue;
+        uint32_t node = 0;
+        for (char ch : word) {
+            uint8_t cls = char_class_[static_cast<unsigned char>(ch)];
+            auto& children = trie[node].children;
+            auto it = std::find_if(children.begin(), children.end(),
+                                   [cls](const std::pair<uint8_t, uint32_t>& edge) { return edge.first == cls; });
+            if (it != children.end()) {
+                node = it->second;
+            } else {
+                uint32_t child = static_cast<uint32_t>(trie.size());
+                children.emplace_back(cls, child);
+                trie.emplace_back();
+                node = child;
+            }
+        }
+        if (trie[node].word == NO_WORD) {
+            trie[node].word = static_cast<uint32_t>(word_offsets.size() - 1);
+            for (char ch : word) word_chars.push_back(static_cast<char>(kFoldTable[static_cast<unsigned char>(ch)]));
+            if (word_chars.size() >= NO_EDGE) throw std::length_error("Word list is too large for the matcher");
+            word_offsets.push_back(static_cast<uint32_t>(word_chars.size()));
+        }
+    }
+    if (trie.size() >= NO_EDGE) throw std::length_error("Word list is too large for the matcher");
+
+    // Renumber states in breadth-first order so fail links can be filled in one forward sweep.
+    std::vector<uint32_t> order;
+    std::vector<uint32_t> new_id(trie.size());
+    order.reserve(trie.size());
+    order.push_back(0);
+    for (size_t i = 0; i < order.size(); ++i) {
+        auto& children = trie[order[i]].children;
+        std::sort(children.begin(), children.end());
+        for (const auto& edge : children) order.push_back(edge.second);
+    }
+    for (size_t i = 0; i < order.size(); ++i) new_id[order[i]] = static_cast<uint32_t>(i);
+
+    size_t state_count = order.size();
+    edge_begin.resize(state_count + 1);
+    edge_label.reserve(state_count - 1);
+    edge_target.reserve(state_count - 1);
+    word_at.resize(state_count);
+    for (size_t i = 0; i < state_count; ++i) {
+        const TrieNode& node = trie[order[i]];
+        edge_begin[i] = static_cast<uint32_t>(edge_label.size());
+        word_at[i] = node.word;
+        for (const auto& edge : node.children) {
+            edge_label.push_back(edge.first);
+            edge_target.push_back(new_id[edge.second]);
+        }
+    }
+    edge_begin[state_count] = static_cast<uint32_t>(edge_label.size());
+
+    // Point the views at the arrays built so far; findEdge and sparseStep below read through them.
+    state_count_ = state_count;
+    edge_count_ = edge_label.size();
+    word_count_ = word_offsets.size() - 1;
+    edge_begin_ = edge_begin.data();
+    edge_label_ = edge_label.data();
+    edge_target_ = edge_target.data();
+    word_at_ = word_at.data();
+    word_offsets_ = word_offsets.data();
+    word_chars_ = word_chars.data();
+
+    fail.assign(state_count, 0);
+    output_link.assign(state_count, 0);
+    fail_ = fail.data();
+    output_link_ = output_link.data();
+    for (uint32_t state = 0; state < state_count; ++state) {
+        for (uint32_t e = edge_begin[state]; e < edge_begin[state + 1]; ++e) {
+            uint32_t target = edge_target[e];
+            if (state != 0) fail[target] = sparseStep(fail[state], edge_label[e]);
+            uint32_t fallback = fail[target];
+            output_link[target] = word_at[fallback] != NO_WORD ? fallback : output_link[fallback];
+        }
+    }
+
+    // A state's fail link always points to a shallower state, which comes earlier in BFS order,
+    // so each dense row can be completed from a row that is already filled in.
+    dense_states_ = static_cast<uint32_t>(std::min(state_count, std::max<size_t>(1, DENSE_TABLE_BUDGET / class_count_)));
+    dense_next.assign(size_t(dense_states_) * class_count_, 0);
+    for (uint32_t state = 0; state < dense_states_; ++state) {
+        uint32_t* row = dense_next.data() + size_t(state) * class_count_;
+        const uint32_t* fallback_row = dense_next.data() + size_t(fail[state]) * class_count_;
+        for (uint32_t cls = 1; cls < class_count_; ++cls) {
+            uint32_t next = findEdge(state, static_cast<uint8_t>(cls));
+            row[cls] = next != NO_EDGE ? next : (state == 0 ? 0 : fallback_row[cls]);
+        }
+    }
+    dense_next_ = dense_next.data();
+    storage_ = std::move(storage);
+}
+
+WordMatcher::WordMatcher(std::shared_ptr<const void> owner, const unsigned char* image, size_t size)
+    : storage_(std::move(owner)) {
+    if (size < sizeof(ImageHeader)) throw std::runtime_error("Truncated word matcher image");
+    ImageHeader header;
+    std::memcpy(&header, image, sizeof(header));
+
+    class_count_ = header.class_count;
+    dense_states_ = header.dense_states;
+    state_count_ = header.state_count;
+    edge_count_ = header.edge_count;
+    word_count_ = header.word_count;
+    std::memcpy(char_class_.data(), header.char_class, sizeof(header.char_class));
+    if (class_count_ == 0 || class_count_ > 256 || state_count_ == 0 || state_count_ >= NO_EDGE ||
+        dense_states_ == 0 || dense_states_ > state_count_ || edge_count_ != state_count_ - 1 ||
+        word_count_ >= state_count_ || header.word_bytes >= NO_EDGE) {
+        throw std::runtime_error("Corrupt word matcher image");
+    }
+
+    size_t offset = sizeof(ImageHeader);
+    auto take = [&](size_t bytes) {
+        const unsigned char* at = image + offset;
+        offset = alignImage(offset + bytes);
+        if (offset > size) throw std::runtime_error("Truncated word matcher image");
+        return at;
+    };
+    dense_next_ = reinterpret_cast<const uint32_t*>(take(size_t(dense_states_) * class_count_ * sizeof(uint32_t)));
+    edge_begin_ = reinterpret_cast<const uint32_t*>(take((state_count_ + 1) * sizeof(uint32_t)));
+    edge_label_ = take(edge_count_);
+    edge_target_ = reinterpret_cast<const uint32_t*>(take(edge_count_ * sizeof(uint32_t)));
+    fail_ = reinterpret_cast<const uint32_t*>(take(state_count_ * sizeof(uint32_t)));
+    word_at_ = reinterpret_cast<const uint32_t*>(take(state_count_ * sizeof(uint32_t)));
+    output_link_ = reinterpret_cast<const uint32_t*>(take(state_count_ * sizeof(uint32_t)));
+    word_offsets_ = reinterpret_cast<const uint32_t*>(take((word_count_ + 1) * sizeof(uint32_t)));
+    word_chars_ = reinterpret_cast<const char*>(take(header.word_bytes));
+    if (edge_begin_[state_count_] != edge_count_ || word_offsets_[word_count_] != header.word_bytes) {
+        throw std::runtime_error("Corrupt word matcher image");
+    }
+}
+
+void WordMatcher::writeImage(std::ostream& out) const {
+    ImageHeader header = {};
+    header.class_count = class_count_;
+    header.dense_states = dense_states_;
+    header.state_count = state_count_;
+    header.edge_count = edge_count_;
+    header.word_count = word_count_;
+    header.word_bytes = word_offsets_[word_count_];
+    std::memcpy(header.char_class, char_class_.data(), sizeof(header.char_class));
+
+    size_t offset = 0;
+    auto put = [&](const void* data, size_t bytes) {
+        static const char padding[IMAGE_ALIGNMENT] = {};
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        size_t aligned = alignImage(offset + bytes);
+        out.write(padding, static_cast<std::streamsize>(aligned - offset - bytes));
+        offset = aligned;
+    };
+    put(&header, sizeof(header));
+    put(dense_next_, size_t(dense_states_) * class_count_ * sizeof(uint32_t));
+    put(edge_begin_, (state_count_ + 1) * sizeof(uint32_t));
+    put(edge_label_, edge_count_);
+    put(edge_target_, edge_count_ * sizeof(uint32_t));
+    put(fail_, state_count_ * sizeof(uint32_t));
+    put(word_at_, state_count_ * sizeof(uint32_t));
+    put(output_link_, state_count_ * sizeof(uint32_t));
+    put(word_offsets_, (word_count_ + 1) * sizeof(uint32_t));
+    put(word_chars_, header.word_bytes);
+}
+
+bool WordMatcher::empty() const {
+    return word_count_ == 0;
+}
+
+size_t WordMatcher::getWordCount() const {
+    return word_count_;
+}
+
+std::string_view WordMatcher::getWord(size_t index) const {
+    if (index >= word_count_) throw std::out_of_range("Word index out of range");
+    return std::string_view(word_chars_ + word_offsets_[index], word_offsets_[index + 1] - word_offsets_[index]);
+}
+
+bool WordMatcher::containsAny(std::string_view text) const {
+    if (word_count_ == 0) return false;
+    Trace::Span span("WordMatcher::containsAny");
+    uint32_t state = 0;
+    for (char ch : text) {
+        state = step(state, char_class_[static_cast<unsigned char>(ch)]);
+        if (word_at_[state] != NO_WORD || output_link_[state] != 0) return true;
+    }
+    return false;
+}
+
+size_t WordMatcher::findAll(std::string_view text, std::vector<WordMatch>& matches) const {
+    size_t found = 0;
+    if (word_count_ == 0) return found;
+    uint32_t state = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        state = step(state, char_class_[static_cast<unsigned char>(text[i])]);
+        for (uint32_t s = word_at_[state] != NO_WORD ? state : output_link_[state]; s != 0; s = output_link_[s]) {
+            uint32_t word = word_at_[s];
+            matches.push_back({ word, i + 1 - (word_offsets_[word + 1] - word_offsets_[word]) });
+            ++found;
+        }
+    }
+    return found;
+}
+
+uint32_t WordMatcher::advance(uint32_t state, char ch) const {
+    return step(state, char_class_[static_cast<unsigned char>(ch)]);
+}
+
+bool WordMatcher::endsWord(uint32_t state) const {
+    return word_at_[state] != NO_WORD || output_link_[state] != 0;
+}
+
+uint32_t WordMatcher::findEdge(uint32_t state, uint8_t cls) const {
+    const uint8_t* first = edge_label_ + edge_begin_[state];
+    const uint8_t* last = edge_label_ + edge_begin_[state + 1];
+    const uint8_t* it = std::lower_bound(first, last, cls);
+    if (it == last || *it != cls) return NO_EDGE;
+    return edge_target_[it - edge_label_];
+}
+
+uint32_t WordMatcher::sparseStep(uint32_t state, uint8_t cls) const {
+    while (true) {
+        uint32_t next = findEdge(state, cls);
+        if (next != NO_EDGE) return next;
+        if (state == 0) return 0;
+        state = fail_[state];
+    }
+}
+
+uint32_t WordMatcher::step(uint32_t state, uint8_t cls) const {
+    if (cls == 0) return 0;
+    while (state >= dense_states_) {
+        uint32_t next = findEdge(state, cls);
+        if (next != NO_EDGE) return next;
+        state = fail_[state];
+    }
+    return dense_next_[size_t(state) * class_count_ + cls];
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#ifndef WORD_MATCHER_HPP
+#define WORD_MATCHER_HPP
+#include <array>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+struct WordMatch {
+    size_t word_index;
+    size_t position;
+};
+
+// Aho-Corasick automaton over a case-folded word list. Matching is a single pass over the text
+// and its cost does not depend on how many words were compiled in.
+//
+// The automaton is a handful of flat arrays, so it can be written out with writeImage and later
+// used in place from a memory mapping. Copies share the arrays.
+class WordMatcher {
+public:
+    WordMatcher();
+    explicit WordMatcher(const std::vector<std::string>& words);
+    // Uses an image written by writeImage without copying it. owner keeps the bytes alive; the
+    // image must start on an 8-byte boundary. Throws std::runtime_error if the sizes do not add up.
+    WordMatcher(std::shared_ptr<const void> owner, const unsigned char* image, size_t size);
+
+    bool empty() const;
+    size_t getWordCount() const;
+    std::string_view getWord(size_t index) const;
+
+    bool containsAny(std::string_view text) const;
+    size_t findAll(std::string_view text, std::vector<WordMatch>& matches) const;
+
+    // Step-at-a-time matching for text that is edited at its end. Start from START_STATE, feed one
+    // character per call and keep the returned states to resume from any earlier length.
+    static constexpr uint32_t START_STATE = 0;
+    uint32_t advance(uint32_t state, char ch) const;
+    // True when some word ends at the character that led to state.
+    bool endsWord(uint32_t state) const;
+
+    // Writes the arrays, padded to 8-byte boundaries relative to the first byte written.
+    void writeImage(std::ostream& out) const;
+
+private:
+    static constexpr uint32_t NO_WORD = UINT32_MAX;
+    struct Storage;
+
+    std::shared_ptr<const void> storage_;
+    std::array<uint8_t, 256> char_class_;
+    uint32_t class_count_;
+    uint32_t dense_states_;
+    size_t state_count_;
+    size_t edge_count_;
+    size_t word_count_;
+    const uint32_t* dense_next_;
+    const uint32_t* edge_begin_;
+    const uint8_t* edge_label_;
+    const uint32_t* edge_target_;
+    const uint32_t* fail_;
+    const uint32_t* word_at_;
+    const uint32_t* output_link_;
+    // Words are stored case-folded and back to back; word i spans word_offsets_[i, i + 1).
+    const uint32_t* word_offsets_;
+    const char* word_chars_;
+
+    uint32_t findEdge(uint32_t state, uint8_t cls) const;
+    uint32_t sparseStep(uint32_t state, uint8_t cls) const;
+    uint32_t step(uint32_t state, uint8_t cls) const;
+};
+
+#endif
\ No newline at end of file